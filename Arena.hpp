@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define XS_HAS_PMR 1
+#endif
+
+namespace xs {
+
+// 单调递增的内存分配器, 只能整体释放
+// 一次请求中的临时字符串/容器都从这里分配, 请求结束时 Reset 一次性回收
+// 非线程安全
+class Arena {
+  public:
+    // @param nBlockSize 首个内存块大小, 之后每块翻倍, 最大 kMaxBlockSize
+    explicit Arena(size_t nBlockSize = 4096)
+        : _nInitBlockSize(nBlockSize < kMinBlockSize ? kMinBlockSize : nBlockSize) {
+        _nNextBlockSize = _nInitBlockSize;
+    }
+
+    // 先使用外部提供的缓冲区(如栈上数组), 用完后再向系统申请
+    Arena(void* pBuffer, size_t nSize, size_t nBlockSize = 4096)
+        : Arena(nBlockSize) {
+        _pInitBuffer = static_cast<char*>(pBuffer);
+        _nInitBufferSize = nSize;
+        _pCur = _pInitBuffer;
+        _pEnd = _pInitBuffer + nSize;
+    }
+
+    ~Arena() {
+        FreeBlocks(nullptr);
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* Alloc(size_t nSize, size_t nAlign = alignof(std::max_align_t)) {
+        // 按相对 _pCur 的偏移比较, 对齐填充超过剩余空间时 p 会越过 _pEnd
+        char* p = AlignUp(_pCur, nAlign);
+        size_t nLeft = (size_t)(_pEnd - _pCur);
+        size_t nPad = (size_t)(p - _pCur);
+        if (_pCur && nPad <= nLeft && nSize <= nLeft - nPad) {
+            _pCur = p + nSize;
+            _nUsed += nSize;
+            return p;
+        }
+        return AllocSlow(nSize, nAlign);
+    }
+
+    // 在 Arena 上构造对象, Reset 时不会调用析构函数
+    template <typename T, typename... Args>
+    T* New(Args&&... args) {
+        return new (Alloc(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // 释放所有分配, 保留最大的一块留给下次使用
+    void Reset() {
+        Block* pKeep = _pBlocks;
+        for (Block* p = _pBlocks; p; p = p->pNext) {
+            if (p->nSize > pKeep->nSize) {
+                pKeep = p;
+            }
+        }
+        FreeBlocks(pKeep);
+        _nUsed = 0;
+        _nNextBlockSize = _nInitBlockSize;
+        if (pKeep && pKeep->nSize > _nInitBufferSize) {
+            pKeep->pNext = nullptr;
+            _pBlocks = pKeep;
+            _pCur = pKeep->Data();
+            _pEnd = _pCur + pKeep->nSize;
+        } else {
+            if (pKeep) {
+                ::operator delete(pKeep);
+            }
+            _pBlocks = nullptr;
+            _pCur = _pInitBuffer;
+            _pEnd = _pInitBuffer ? _pInitBuffer + _nInitBufferSize : nullptr;
+        }
+    }
+
+    // 已分配出去的字节数(不含对齐填充)
+    size_t Used() const {
+        return _nUsed;
+    }
+
+    // 向系统申请的字节数
+    size_t Reserved() const {
+        size_t nSize = 0;
+        for (Block* p = _pBlocks; p; p = p->pNext) {
+            nSize += p->nSize;
+        }
+        return nSize;
+    }
+
+  private:
+    static constexpr size_t kMinBlockSize = 256;
+    static constexpr size_t kMaxBlockSize = 1 << 20;
+
+    struct alignas(std::max_align_t) Block {
+        Block* pNext;
+        size_t nSize;
+
+        char* Data() {
+            return reinterpret_cast<char*>(this + 1);
+        }
+    };
+
+    static char* AlignUp(char* p, size_t nAlign) {
+        uintptr_t n = reinterpret_cast<uintptr_t>(p);
+        return reinterpret_cast<char*>((n + nAlign - 1) & ~(uintptr_t)(nAlign - 1));
+    }
+
+    void* AllocSlow(size_t nSize, size_t nAlign) {
+        size_t nNeed = nSize + nAlign;
+        size_t nBlockSize = _nNextBlockSize;
+        if (nBlockSize < nNeed) {
+            nBlockSize = nNeed;
+        }
+        if (_nNextBlockSize < kMaxBlockSize) {
+            _nNextBlockSize *= 2;
+        }
+        Block* pBlock = static_cast<Block*>(::operator new(sizeof(Block) + nBlockSize));
+        pBlock->pNext = _pBlocks;
+        pBlock->nSize = nBlockSize;
+        _pBlocks = pBlock;
+        _pCur = pBlock->Data();
+        _pEnd = _pCur + nBlockSize;
+
+        char* p = AlignUp(_pCur, nAlign);
+        _pCur = p + nSize;
+        _nUsed += nSize;
+        return p;
+    }
+
+    // 释放除 pKeep 以外的所有块
+    void FreeBlocks(Block* pKeep) {
+        Block* p = _pBlocks;
+        while (p) {
+            Block* pNext = p->pNext;
+            if (p != pKeep) {
+                ::operator delete(p);
+            }
+            p = pNext;
+        }
+        _pBlocks = nullptr;
+    }
+
+    Block* _pBlocks = nullptr;
+    char* _pCur = nullptr;
+    char* _pEnd = nullptr;
+    char* _pInitBuffer = nullptr;
+    size_t _nInitBufferSize = 0;
+    size_t _nInitBlockSize = 0;
+    size_t _nNextBlockSize = 0;
+    size_t _nUsed = 0;
+};
+
+#ifdef XS_HAS_PMR
+// 把 Arena 适配成 std::pmr::memory_resource, 供 pmr 容器使用
+// Arena arena; ArenaResource res(arena); std::pmr::vector<std::pmr::string> v(&res);
+class ArenaResource : public std::pmr::memory_resource {
+  public:
+    explicit ArenaResource(Arena& arena)
+        : _arena(arena) {
+    }
+
+    Arena& GetArena() const {
+        return _arena;
+    }
+
+  protected:
+    void* do_allocate(size_t nBytes, size_t nAlign) override {
+        return _arena.Alloc(nBytes, nAlign);
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {
+        // 单调分配, 由 Arena::Reset 统一回收
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+  private:
+    Arena& _arena;
+};
+#endif
+} // namespace xs
@@ -0,0 +1,327 @@
+#pragma once
+
+// C++20 协程支持: Task<T>, Spawn, ScheduleOn
+// TaskPool::Schedule, Timer::Sleep, Queue::PopAsync 在 XS_HAS_COROUTINE 定义时可用
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define XS_HAS_COROUTINE 1
+#endif
+
+#ifdef XS_HAS_COROUTINE
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace xs {
+
+// 协程帧分配器, 按 64 字节分级的线程本地空闲链表, 超过 kMaxSize 直接走全局 new
+class FramePool {
+  public:
+    static constexpr size_t kGranularity = 64;
+    static constexpr size_t kMaxSize = 1024;
+    static constexpr size_t kMaxCache = 64;
+
+    static void* Alloc(size_t n) {
+        if (n > kMaxSize) {
+            return ::operator new(n);
+        }
+        FreeList& kList = Local().kLists[ClassOf(n)];
+        if (kList.pHead) {
+            Node* pNode = kList.pHead;
+            kList.pHead = pNode->pNext;
+            --kList.nCount;
+            return pNode;
+        }
+        return ::operator new((ClassOf(n) + 1) * kGranularity);
+    }
+
+    static void Free(void* p, size_t n) {
+        if (n > kMaxSize) {
+            ::operator delete(p);
+            return;
+        }
+        FreeList& kList = Local().kLists[ClassOf(n)];
+        if (kList.nCount >= kMaxCache) {
+            ::operator delete(p);
+            return;
+        }
+        Node* pNode = static_cast<Node*>(p);
+        pNode->pNext = kList.pHead;
+        kList.pHead = pNode;
+        ++kList.nCount;
+    }
+
+  private:
+    struct Node {
+        Node* pNext;
+    };
+
+    struct FreeList {
+        Node* pHead = nullptr;
+        size_t nCount = 0;
+    };
+
+    struct Cache {
+        FreeList kLists[kMaxSize / kGranularity];
+
+        ~Cache() {
+            for (auto& kList : kLists) {
+                while (kList.pHead) {
+                    Node* pNext = kList.pHead->pNext;
+                    ::operator delete(kList.pHead);
+                    kList.pHead = pNext;
+                }
+            }
+        }
+    };
+
+    static size_t ClassOf(size_t n) {
+        return n == 0 ? 0 : (n - 1) / kGranularity;
+    }
+
+    static Cache& Local() {
+        static thread_local Cache kCache;
+        return kCache;
+    }
+};
+
+template <typename T = void>
+class Task;
+
+namespace detail {
+
+struct TaskPromiseBase {
+    std::coroutine_handle<> hContinuation;
+    std::exception_ptr pError;
+
+    static void* operator new(size_t n) {
+        return FramePool::Alloc(n);
+    }
+
+    static void operator delete(void* p, size_t n) {
+        FramePool::Free(p, n);
+    }
+
+    std::suspend_always initial_suspend() noexcept {
+        return {};
+    }
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept {
+            return false;
+        }
+
+        template <typename TPromise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> h) noexcept {
+            std::coroutine_handle<> hNext = h.promise().hContinuation;
+            return hNext ? hNext : std::noop_coroutine();
+        }
+
+        void await_resume() noexcept {
+        }
+    };
+
+    FinalAwaiter final_suspend() noexcept {
+        return {};
+    }
+
+    void unhandled_exception() {
+        pError = std::current_exception();
+    }
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase {
+    std::optional<T> kValue;
+
+    Task<T> get_return_object();
+
+    template <typename U>
+    void return_value(U&& value) {
+        kValue.emplace(std::forward<U>(value));
+    }
+
+    T TakeResult() {
+        if (pError) {
+            std::rethrow_exception(pError);
+        }
+        return std::move(*kValue);
+    }
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object();
+
+    void return_void() {
+    }
+
+    void TakeResult() {
+        if (pError) {
+            std::rethrow_exception(pError);
+        }
+    }
+};
+
+// Spawn 使用的分离协程, 结束后自动销毁
+struct DetachedTask {
+    struct promise_type {
+        static void* operator new(size_t n) {
+            return FramePool::Alloc(n);
+        }
+
+        static void operator delete(void* p, size_t n) {
+            FramePool::Free(p, n);
+        }
+
+        DetachedTask get_return_object() noexcept {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept {
+            return {};
+        }
+
+        void return_void() noexcept {
+        }
+
+        void unhandled_exception() noexcept {
+            std::terminate();
+        }
+    };
+};
+} // namespace detail
+
+// 惰性协程任务, co_await 时才开始执行, 结束后恢复等待者
+template <typename T>
+class Task {
+  public:
+    using promise_type = detail::TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() noexcept {}
+
+    explicit Task(Handle h) noexcept
+        : _h(h) {
+    }
+
+    Task(Task&& other) noexcept
+        : _h(std::exchange(other._h, nullptr)) {
+    }
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (_h) {
+                _h.destroy();
+            }
+            _h = std::exchange(other._h, nullptr);
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        if (_h) {
+            _h.destroy();
+        }
+    }
+
+    bool Valid() const noexcept {
+        return (bool)_h;
+    }
+
+    auto operator co_await() noexcept {
+        struct Awaiter {
+            Handle h;
+
+            bool await_ready() noexcept {
+                return !h || h.done();
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> hWaiter) noexcept {
+                h.promise().hContinuation = hWaiter;
+                return h;
+            }
+
+            // 空 Task(默认构造或已被移走)没有结果可取
+            T await_resume() {
+                if (!h) {
+                    throw std::future_error(std::future_errc::no_state);
+                }
+                return h.promise().TakeResult();
+            }
+        };
+        return Awaiter{_h};
+    }
+
+  private:
+    Handle _h;
+};
+
+namespace detail {
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+template <typename T>
+DetachedTask RunDetached(Task<T> task) {
+    co_await task;
+}
+} // namespace detail
+
+// 在当前线程启动 task, 不等待结果; task 中未捕获的异常会终止进程
+template <typename T>
+void Spawn(Task<T> task) {
+    detail::RunDetached(std::move(task));
+}
+
+// co_await ScheduleOn(pool) 把协程切换到 pool 的工作线程上继续执行
+template <typename TPool>
+class ScheduleAwaiter {
+  public:
+    explicit ScheduleAwaiter(TPool& pool)
+        : _pool(pool) {
+    }
+
+    bool await_ready() noexcept {
+        return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> h) {
+        // 投递失败(线程池已停止)时在当前线程继续
+        return _pool.PushTask([h]() {
+            h.resume();
+        });
+    }
+
+    void await_resume() noexcept {
+    }
+
+  private:
+    TPool& _pool;
+};
+
+template <typename TPool>
+ScheduleAwaiter<TPool> ScheduleOn(TPool& pool) {
+    return ScheduleAwaiter<TPool>(pool);
+}
+} // namespace xs
+
+#endif
@@ -1,13 +1,13 @@
 #pragma once
 
-#include <functional>
+#include "InplaceTask.hpp"
 
 namespace xs {
 
 class Defer {
   public:
-    Defer(const std::function<void()>&& f)
-        : _f(f) {
+    Defer(InplaceTask f)
+        : _f(std::move(f)) {
     }
 
     ~Defer() {
@@ -22,7 +22,7 @@ class Defer {
     }
 
     bool _cancel = false;
-    std::function<void()> _f;
+    InplaceTask _f;
 };
 
 }
\ No newline at end of file
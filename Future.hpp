@@ -0,0 +1,547 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "InplaceTask.hpp"
+#include "RingQueue.hpp"
+
+namespace xs {
+
+// 执行器引用, 把任务投递到 TaskPool/WorkStealingPool 等任何提供 PushTask 的对象
+struct Executor {
+    void* pContext = nullptr;
+    bool (*fnPost)(void*, InplaceTask&&) = nullptr;
+
+    template <typename TPool>
+    static Executor Of(TPool& pool) {
+        Executor kExecutor;
+        kExecutor.pContext = &pool;
+        kExecutor.fnPost = [](void* p, InplaceTask&& func) -> bool {
+            return static_cast<TPool*>(p)->PushTask(std::move(func));
+        };
+        return kExecutor;
+    }
+
+    explicit operator bool() const {
+        return fnPost != nullptr;
+    }
+
+    bool Post(InplaceTask&& func) const {
+        return fnPost && fnPost(pContext, std::move(func));
+    }
+};
+
+template <typename T>
+class Future;
+
+template <typename T>
+class Promise;
+
+namespace detail {
+
+struct Unit {};
+
+template <typename T>
+using FutureValueT = typename std::conditional<std::is_void<T>::value, Unit, T>::type;
+
+// 状态对象池, 按具体状态类型区分
+// 先用线程本地空闲链表, 本地满了放入全局无锁环形缓冲, 生产线程与释放线程不同时也能复用
+template <typename TState>
+class StatePool {
+  public:
+    static constexpr size_t kMaxLocal = 32;
+    static constexpr size_t kMaxGlobal = 1024;
+
+    template <typename... Args>
+    static TState* Alloc(Args&&... args) {
+        FreeList& kList = Local();
+        TState* pState = kList.pHead;
+        if (pState) {
+            kList.pHead = static_cast<TState*>(pState->pNextFree);
+            --kList.nCount;
+        } else if (!Global().TryPop(pState)) {
+            pState = new TState();
+        }
+        pState->Init(std::forward<Args>(args)...);
+        return pState;
+    }
+
+    static void Free(TState* pState) {
+        pState->Reset();
+        FreeList& kList = Local();
+        if (kList.nCount < kMaxLocal) {
+            pState->pNextFree = kList.pHead;
+            kList.pHead = pState;
+            ++kList.nCount;
+        } else if (!Global().TryEmplace(pState)) {
+            delete pState;
+        }
+    }
+
+  private:
+    struct FreeList {
+        TState* pHead = nullptr;
+        size_t nCount = 0;
+
+        ~FreeList() {
+            while (pHead) {
+                TState* pNext = static_cast<TState*>(pHead->pNextFree);
+                delete pHead;
+                pHead = pNext;
+            }
+        }
+    };
+
+    static FreeList& Local() {
+        static thread_local FreeList kList;
+        return kList;
+    }
+
+    // 进程退出时不回收, 避免与其它线程的析构顺序问题
+    static RingBuffer<TState*, kMaxGlobal>& Global() {
+        static RingBuffer<TState*, kMaxGlobal>* pGlobal = new RingBuffer<TState*, kMaxGlobal>();
+        return *pGlobal;
+    }
+};
+
+// Future 与生产者共享的状态, 引用计数在对象内部
+template <typename T>
+class FutureState {
+  public:
+    using ValueType = FutureValueT<T>;
+
+    virtual ~FutureState() {}
+
+    void AddRef() {
+        _nRef.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Release() {
+        if (_nRef.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            Destroy();
+        }
+    }
+
+    bool Ready() {
+        std::lock_guard<std::mutex> kLock(_lock);
+        return _bReady;
+    }
+
+    void Wait() {
+        std::unique_lock<std::mutex> kLock(_lock);
+        _cond.wait(kLock, [this]() -> bool {
+            return _bReady;
+        });
+    }
+
+    template <typename Rep, typename Period>
+    bool WaitFor(const std::chrono::duration<Rep, Period>& d) {
+        std::unique_lock<std::mutex> kLock(_lock);
+        return _cond.wait_for(kLock, d, [this]() -> bool {
+            return _bReady;
+        });
+    }
+
+    template <typename... Args>
+    void SetValue(Args&&... args) {
+        InplaceTask fnContinuation;
+        {
+            std::lock_guard<std::mutex> kLock(_lock);
+            if (_bReady) {
+                return;
+            }
+            _value.emplace(std::forward<Args>(args)...);
+            _bReady = true;
+            fnContinuation = std::move(_fnContinuation);
+        }
+        _cond.notify_all();
+        if (fnContinuation) {
+            fnContinuation();
+        }
+    }
+
+    void SetException(std::exception_ptr pError) {
+        InplaceTask fnContinuation;
+        {
+            std::lock_guard<std::mutex> kLock(_lock);
+            if (_bReady) {
+                return;
+            }
+            _pError = pError;
+            _bReady = true;
+            fnContinuation = std::move(_fnContinuation);
+        }
+        _cond.notify_all();
+        if (fnContinuation) {
+            fnContinuation();
+        }
+    }
+
+    // 就绪后调用 func, 已就绪则立即调用
+    void OnReady(InplaceTask func) {
+        {
+            std::lock_guard<std::mutex> kLock(_lock);
+            if (!_bReady) {
+                _fnContinuation = std::move(func);
+                return;
+            }
+        }
+        func();
+    }
+
+    // 就绪后才能调用
+    ValueType TakeValue() {
+        if (_pError) {
+            std::rethrow_exception(_pError);
+        }
+        return std::move(*_value);
+    }
+
+    std::exception_ptr Error() const {
+        return _pError;
+    }
+
+    const Executor& GetExecutor() const {
+        return _kExecutor;
+    }
+
+    void* pNextFree = nullptr;
+
+  protected:
+    void InitState(const Executor& kExecutor) {
+        _nRef.store(1, std::memory_order_relaxed);
+        _kExecutor = kExecutor;
+    }
+
+    void ResetState() {
+        _value.reset();
+        _pError = nullptr;
+        _bReady = false;
+        _fnContinuation = nullptr;
+        _kExecutor = Executor();
+    }
+
+    virtual void Destroy() = 0;
+
+    std::atomic<int32_t> _nRef = {0};
+    std::mutex _lock;
+    std::condition_variable _cond;
+    bool _bReady = false;
+    std::optional<ValueType> _value;
+    std::exception_ptr _pError;
+    InplaceTask _fnContinuation;
+    Executor _kExecutor;
+};
+
+template <typename T>
+class PromiseState final : public FutureState<T> {
+  public:
+    void Init(const Executor& kExecutor) {
+        this->InitState(kExecutor);
+    }
+
+    void Reset() {
+        this->ResetState();
+    }
+
+  protected:
+    void Destroy() override {
+        StatePool<PromiseState>::Free(this);
+    }
+};
+
+// 调用 fn 并把结果写入 pState
+template <typename T, typename Fn, typename... Args>
+void InvokeInto(FutureState<T>* pState, Fn& fn, Args&&... args) {
+    try {
+        if constexpr (std::is_void<T>::value) {
+            fn(std::forward<Args>(args)...);
+            pState->SetValue();
+        } else {
+            pState->SetValue(fn(std::forward<Args>(args)...));
+        }
+    } catch (...) {
+        pState->SetException(std::current_exception());
+    }
+}
+
+// 由 Submit 创建, 可调用对象直接存放在池化的状态里
+template <typename T, typename Fn>
+class TaskState final : public FutureState<T> {
+  public:
+    template <typename F>
+    void Init(const Executor& kExecutor, F&& fn) {
+        this->InitState(kExecutor);
+        _fn.emplace(std::forward<F>(fn));
+    }
+
+    void Reset() {
+        _fn.reset();
+        this->ResetState();
+    }
+
+    void Run() {
+        InvokeInto<T>(this, *_fn);
+        _fn.reset();
+    }
+
+  protected:
+    void Destroy() override {
+        StatePool<TaskState>::Free(this);
+    }
+
+    std::optional<Fn> _fn;
+};
+
+// Then 创建的状态, 前一个 Future 就绪后在执行器上调用 fn
+template <typename T, typename Fn, typename TPrev>
+class ThenState final : public FutureState<T> {
+  public:
+    template <typename F>
+    void Init(const Executor& kExecutor, F&& fn, FutureState<TPrev>* pPrev) {
+        this->InitState(kExecutor);
+        _fn.emplace(std::forward<F>(fn));
+        _pPrev = pPrev;
+    }
+
+    void Reset() {
+        _fn.reset();
+        _pPrev = nullptr;
+        this->ResetState();
+    }
+
+    void Run() {
+        std::exception_ptr pError = _pPrev->Error();
+        if (pError) {
+            this->SetException(pError);
+        } else if constexpr (std::is_void<TPrev>::value) {
+            InvokeInto<T>(this, *_fn);
+        } else {
+            InvokeInto<T>(this, *_fn, _pPrev->TakeValue());
+        }
+        _fn.reset();
+        _pPrev->Release();
+        _pPrev = nullptr;
+    }
+
+  protected:
+    void Destroy() override {
+        StatePool<ThenState>::Free(this);
+    }
+
+    std::optional<Fn> _fn;
+    FutureState<TPrev>* _pPrev = nullptr;
+};
+
+// 在执行器上运行 pState->Run(), 任务持有一个引用
+template <typename TState>
+void PostRun(const Executor& kExecutor, TState* pState) {
+    pState->AddRef();
+    bool bPosted = kExecutor.Post([pState]() {
+        pState->Run();
+        pState->Release();
+    });
+    if (!bPosted) {
+        // 执行器不存在或已停止, 就地执行
+        pState->Run();
+        pState->Release();
+    }
+}
+
+template <typename T>
+Future<T> MakeFuture(FutureState<T>* pState);
+} // namespace detail
+
+// 轻量 Future, 共享状态来自线程本地对象池
+template <typename T>
+class Future {
+  public:
+    using ValueType = detail::FutureValueT<T>;
+
+    Future() {}
+
+    Future(Future&& other) noexcept
+        : _pState(other._pState) {
+        other._pState = nullptr;
+    }
+
+    Future& operator=(Future&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            _pState = other._pState;
+            other._pState = nullptr;
+        }
+        return *this;
+    }
+
+    Future(const Future&) = delete;
+    Future& operator=(const Future&) = delete;
+
+    ~Future() {
+        Reset();
+    }
+
+    bool Valid() const {
+        return _pState != nullptr;
+    }
+
+    bool Ready() const {
+        return _pState && _pState->Ready();
+    }
+
+    void Wait() const {
+        _pState->Wait();
+    }
+
+    template <typename Rep, typename Period>
+    bool WaitFor(const std::chrono::duration<Rep, Period>& d) const {
+        return _pState->WaitFor(d);
+    }
+
+    // 阻塞直到就绪并取出结果, 之后 Future 失效
+    T Get() {
+        _pState->Wait();
+        detail::FutureState<T>* pState = _pState;
+        _pState = nullptr;
+        struct Releaser {
+            detail::FutureState<T>* p;
+            ~Releaser() {
+                p->Release();
+            }
+        } kReleaser{pState};
+        if constexpr (std::is_void<T>::value) {
+            pState->TakeValue();
+        } else {
+            return pState->TakeValue();
+        }
+    }
+
+    // 就绪后在产生本 Future 的执行器上调用 fn(value), 不阻塞当前线程
+    // 没有执行器时(如 Promise)在设置结果的线程上调用
+    // 之后本 Future 失效
+    template <typename F>
+    auto Then(F&& fn) {
+        using Fn = typename std::decay<F>::type;
+        using R = typename std::conditional<std::is_void<T>::value, std::invoke_result<Fn&>, std::invoke_result<Fn&, ValueType>>::type::type;
+        using TState = detail::ThenState<R, Fn, T>;
+
+        detail::FutureState<T>* pPrev = _pState;
+        _pState = nullptr;
+        Executor kExecutor = pPrev->GetExecutor();
+        TState* pState = detail::StatePool<TState>::Alloc(kExecutor, std::forward<F>(fn), pPrev);
+        Future<R> kFuture = detail::MakeFuture<R>(pState);
+        // 创建时的引用交给回调持有
+        pPrev->OnReady([pState]() {
+            detail::PostRun(pState->GetExecutor(), pState);
+            pState->Release();
+        });
+        return kFuture;
+    }
+
+  private:
+    template <typename U>
+    friend Future<U> detail::MakeFuture(detail::FutureState<U>* pState);
+
+    explicit Future(detail::FutureState<T>* pState)
+        : _pState(pState) {
+    }
+
+    void Reset() {
+        if (_pState) {
+            _pState->Release();
+            _pState = nullptr;
+        }
+    }
+
+    detail::FutureState<T>* _pState = nullptr;
+};
+
+template <typename T>
+Future<T> detail::MakeFuture(FutureState<T>* pState) {
+    pState->AddRef();
+    return Future<T>(pState);
+}
+
+template <typename T>
+class Promise {
+  public:
+    using ValueType = detail::FutureValueT<T>;
+
+    explicit Promise(const Executor& kExecutor = Executor()) {
+        _pState = detail::StatePool<detail::PromiseState<T>>::Alloc(kExecutor);
+    }
+
+    Promise(Promise&& other) noexcept
+        : _pState(other._pState) {
+        other._pState = nullptr;
+    }
+
+    Promise& operator=(Promise&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            _pState = other._pState;
+            other._pState = nullptr;
+        }
+        return *this;
+    }
+
+    Promise(const Promise&) = delete;
+    Promise& operator=(const Promise&) = delete;
+
+    ~Promise() {
+        Reset();
+    }
+
+    Future<T> GetFuture() {
+        return detail::MakeFuture<T>(_pState);
+    }
+
+    template <typename... Args>
+    void SetValue(Args&&... args) {
+        _pState->SetValue(std::forward<Args>(args)...);
+    }
+
+    void SetException(std::exception_ptr pError) {
+        _pState->SetException(pError);
+    }
+
+  private:
+    void Reset() {
+        if (_pState) {
+            // 未设置结果就销毁, 等待方会得到 broken_promise
+            _pState->SetException(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+            _pState->Release();
+            _pState = nullptr;
+        }
+    }
+
+    detail::PromiseState<T>* _pState = nullptr;
+};
+
+// 把 fn(args...) 投递到 pool 并返回其结果的 Future
+template <typename TPool, typename F, typename... Args>
+auto SubmitTo(TPool& pool, F&& fn, Args&&... args) {
+    auto kBound = [fn = std::forward<F>(fn), kArgs = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+        return std::apply(fn, kArgs);
+    };
+    using Fn = decltype(kBound);
+    using R = typename std::invoke_result<Fn&>::type;
+    using TState = detail::TaskState<R, Fn>;
+
+    Executor kExecutor = Executor::Of(pool);
+    TState* pState = detail::StatePool<TState>::Alloc(kExecutor, std::move(kBound));
+    Future<R> kFuture = detail::MakeFuture<R>(pState);
+    detail::PostRun(kExecutor, pState);
+    pState->Release();
+    return kFuture;
+}
+} // namespace xs
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace xs {
+
+#ifndef XS_INPLACE_TASK_SIZE
+#define XS_INPLACE_TASK_SIZE 64
+#endif
+
+// 只能移动的 void() 可调用对象, 替代 std::function<void()>
+// 可调用对象不超过 N 字节且移动不抛异常时存放在内部缓冲区, 不分配堆内存; 否则退化为堆分配
+template <size_t N>
+class InplaceTaskT {
+  public:
+    InplaceTaskT() noexcept {}
+
+    InplaceTaskT(std::nullptr_t) noexcept {}
+
+    template <typename F,
+              typename Fn = typename std::decay<F>::type,
+              typename = typename std::enable_if<!std::is_same<Fn, InplaceTaskT>::value>::type,
+              typename = decltype(std::declval<Fn&>()())>
+    InplaceTaskT(F&& f) {
+        if (IsNull(f)) {
+            return;
+        }
+        if (IsInplace<Fn>()) {
+            new (&_buffer) Fn(std::forward<F>(f));
+        } else {
+            *reinterpret_cast<Fn**>(&_buffer) = new Fn(std::forward<F>(f));
+        }
+        _pOps = &OpsFor<Fn>::kOps;
+    }
+
+    InplaceTaskT(InplaceTaskT&& other) noexcept {
+        MoveFrom(other);
+    }
+
+    InplaceTaskT& operator=(InplaceTaskT&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    InplaceTaskT& operator=(std::nullptr_t) noexcept {
+        Reset();
+        return *this;
+    }
+
+    InplaceTaskT(const InplaceTaskT&) = delete;
+    InplaceTaskT& operator=(const InplaceTaskT&) = delete;
+
+    ~InplaceTaskT() {
+        Reset();
+    }
+
+    explicit operator bool() const noexcept {
+        return _pOps != nullptr;
+    }
+
+    void operator()() {
+        _pOps->fnInvoke(&_buffer);
+    }
+
+    void Reset() noexcept {
+        if (_pOps) {
+            _pOps->fnDestroy(&_buffer);
+            _pOps = nullptr;
+        }
+    }
+
+    // 可调用对象 F 是否会存放在内部缓冲区
+    template <typename F>
+    static constexpr bool IsInplace() {
+        return sizeof(F) <= N && alignof(F) <= alignof(Storage) && std::is_nothrow_move_constructible<F>::value;
+    }
+
+    static constexpr size_t Capacity() {
+        return N;
+    }
+
+  private:
+    using Storage = typename std::aligned_storage<N, alignof(std::max_align_t)>::type;
+
+    struct Ops {
+        void (*fnInvoke)(void*);
+        // 把 src 中的对象移动到 dst 并销毁 src
+        void (*fnMove)(void* dst, void* src);
+        void (*fnDestroy)(void*);
+    };
+
+    template <typename Fn, bool bInplace = IsInplace<Fn>()>
+    struct OpsFor {
+        static void Invoke(void* p) {
+            (*static_cast<Fn*>(p))();
+        }
+        static void Move(void* dst, void* src) {
+            Fn* pSrc = static_cast<Fn*>(src);
+            new (dst) Fn(std::move(*pSrc));
+            pSrc->~Fn();
+        }
+        static void Destroy(void* p) {
+            static_cast<Fn*>(p)->~Fn();
+        }
+        static constexpr Ops kOps = {&Invoke, &Move, &Destroy};
+    };
+
+    template <typename Fn>
+    struct OpsFor<Fn, false> {
+        static void Invoke(void* p) {
+            (**static_cast<Fn**>(p))();
+        }
+        static void Move(void* dst, void* src) {
+            *static_cast<Fn**>(dst) = *static_cast<Fn**>(src);
+        }
+        static void Destroy(void* p) {
+            delete *static_cast<Fn**>(p);
+        }
+        static constexpr Ops kOps = {&Invoke, &Move, &Destroy};
+    };
+
+    template <typename F>
+    static bool IsNull(const F&) {
+        return false;
+    }
+
+    template <typename R, typename... Args>
+    static bool IsNull(R (*const& f)(Args...)) {
+        return f == nullptr;
+    }
+
+    template <typename R, typename... Args>
+    static bool IsNull(const std::function<R(Args...)>& f) {
+        return !f;
+    }
+
+    void MoveFrom(InplaceTaskT& other) noexcept {
+        if (other._pOps) {
+            other._pOps->fnMove(&_buffer, &other._buffer);
+            _pOps = other._pOps;
+            other._pOps = nullptr;
+        }
+    }
+
+    const Ops* _pOps = nullptr;
+    Storage _buffer;
+};
+
+using InplaceTask = InplaceTaskT<XS_INPLACE_TASK_SIZE>;
+} // namespace xs
@@ -3,39 +3,187 @@
 #include <stack>
 #include <memory>
 #include <functional>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "RingQueue.hpp"
 
 namespace xs {
 
 template <typename T>
 class ObjectPoolT {
+    struct Slot;
+
   public:
     using ClearFunc = std::function<void(T&)>;
     ObjectPoolT() {}
     ObjectPoolT(ClearFunc clear) : _cleaner(clear) {}
 
-    std::shared_ptr<T> Alloc() {
-        T* res = nullptr;
-
-        if (_cache.empty()) {
-            res = new T;
-        } else {
-            res = _cache.top();
+    ~ObjectPoolT() {
+        while (!_cache.empty()) {
+            delete _cache.top();
             _cache.pop();
         }
+    }
 
-        static auto deleter = [&](T* res) {
-            if (_cache.size() >= _cache_max_cnt) {
-                delete res;
-                return;
+    ObjectPoolT(const ObjectPoolT&) = delete;
+    ObjectPoolT& operator=(const ObjectPoolT&) = delete;
+
+    // 独占句柄, 析构时对象回到池中, 不额外分配内存
+    class UniqueHandle {
+      public:
+        UniqueHandle() {}
+
+        UniqueHandle(UniqueHandle&& other) noexcept
+            : _pSlot(other._pSlot) {
+            other._pSlot = nullptr;
+        }
+
+        UniqueHandle& operator=(UniqueHandle&& other) noexcept {
+            if (this != &other) {
+                Reset();
+                _pSlot = other._pSlot;
+                other._pSlot = nullptr;
+            }
+            return *this;
+        }
+
+        UniqueHandle(const UniqueHandle&) = delete;
+        UniqueHandle& operator=(const UniqueHandle&) = delete;
+
+        ~UniqueHandle() {
+            Reset();
+        }
+
+        T* Get() const {
+            return _pSlot ? &_pSlot->kObj : nullptr;
+        }
+
+        T* operator->() const {
+            return &_pSlot->kObj;
+        }
+
+        T& operator*() const {
+            return _pSlot->kObj;
+        }
+
+        explicit operator bool() const {
+            return _pSlot != nullptr;
+        }
+
+        void Reset() {
+            if (_pSlot) {
+                _pSlot->pPool->Recycle(_pSlot);
+                _pSlot = nullptr;
             }
+        }
+
+      private:
+        friend class ObjectPoolT;
+
+        explicit UniqueHandle(Slot* pSlot)
+            : _pSlot(pSlot) {
+        }
+
+        Slot* _pSlot = nullptr;
+    };
+
+    // 共享句柄, 引用计数存放在对象所在的槽中, 拷贝不分配内存
+    // 与池一样非线程安全, 计数不是原子的
+    class RefHandle {
+      public:
+        RefHandle() {}
+
+        RefHandle(const RefHandle& other)
+            : _pSlot(other._pSlot) {
+            if (_pSlot) {
+                ++_pSlot->nRef;
+            }
+        }
+
+        RefHandle(RefHandle&& other) noexcept
+            : _pSlot(other._pSlot) {
+            other._pSlot = nullptr;
+        }
+
+        RefHandle& operator=(const RefHandle& other) {
+            if (_pSlot != other._pSlot) {
+                RefHandle kTemp(other);
+                std::swap(_pSlot, kTemp._pSlot);
+            }
+            return *this;
+        }
+
+        RefHandle& operator=(RefHandle&& other) noexcept {
+            if (this != &other) {
+                Reset();
+                _pSlot = other._pSlot;
+                other._pSlot = nullptr;
+            }
+            return *this;
+        }
+
+        ~RefHandle() {
+            Reset();
+        }
+
+        T* Get() const {
+            return _pSlot ? &_pSlot->kObj : nullptr;
+        }
+
+        T* operator->() const {
+            return &_pSlot->kObj;
+        }
+
+        T& operator*() const {
+            return _pSlot->kObj;
+        }
 
-            if (_cleaner) {
-                _cleaner(*res);
+        explicit operator bool() const {
+            return _pSlot != nullptr;
+        }
+
+        uint32_t UseCount() const {
+            return _pSlot ? _pSlot->nRef : 0;
+        }
+
+        void Reset() {
+            if (_pSlot) {
+                if (--_pSlot->nRef == 0) {
+                    _pSlot->pPool->Recycle(_pSlot);
+                }
+                _pSlot = nullptr;
             }
-            _cache.push(res);
-        };
+        }
+
+      private:
+        friend class ObjectPoolT;
+
+        explicit RefHandle(Slot* pSlot)
+            : _pSlot(pSlot) {
+            _pSlot->nRef = 1;
+        }
+
+        Slot* _pSlot = nullptr;
+    };
+
+    std::shared_ptr<T> Alloc() {
+        T* res = &Take()->kObj;
+
+        // 每次捕获当前池, 不能用 static, 否则所有池都会归还到第一个池
+        return std::shared_ptr<T>(res, [this](T* p) {
+            Recycle(SlotOf(p));
+        });
+    }
 
-        return std::shared_ptr<T>(res, deleter);
+    // 池预热后不再分配堆内存, 句柄不能比池活得更久
+    UniqueHandle AllocUnique() {
+        return UniqueHandle(Take());
+    }
+
+    RefHandle AllocRef() {
+        return RefHandle(Take());
     }
 
     size_t Size() const {
@@ -47,8 +195,467 @@ class ObjectPoolT {
     }
 
   private:
+    // 对象与句柄所需的信息放在一起, 一次分配
+    struct Slot {
+        T kObj;
+        uint32_t nRef = 0;
+        ObjectPoolT* pPool = nullptr;
+    };
+
+    static Slot* SlotOf(T* p) {
+        // kObj 是 Slot 的第一个成员
+        return reinterpret_cast<Slot*>(p);
+    }
+
+    Slot* Take() {
+        Slot* pSlot = nullptr;
+        if (_cache.empty()) {
+            pSlot = new Slot;
+            pSlot->pPool = this;
+        } else {
+            pSlot = _cache.top();
+            _cache.pop();
+        }
+        return pSlot;
+    }
+
+    void Recycle(Slot* pSlot) {
+        if (_cache.size() >= _cache_max_cnt) {
+            delete pSlot;
+            return;
+        }
+
+        if (_cleaner) {
+            _cleaner(pSlot->kObj);
+        }
+        _cache.push(pSlot);
+    }
+
     size_t _cache_max_cnt = 100;
-    std::stack<T*> _cache;
+    // vector 作底层容器, 反复进出不会释放内存
+    std::stack<Slot*, std::vector<Slot*>> _cache;
     ClearFunc _cleaner = nullptr;
 };
-} // namespace xs
\ No newline at end of file
+
+// 按块分配的对象池, 每块连续存放 N 个对象, 块内空闲槽串成链表
+// 对象在 Alloc 时原地构造, 归还时析构; 非线程安全, 池必须比分配出的对象活得久
+template <typename T, size_t N = 64>
+class SlabObjectPoolT {
+    struct Slab;
+
+  public:
+    // 归还对象到所属的池, 不占额外空间
+    struct Deleter {
+        void operator()(T* p) const {
+            Slot* pSlot = reinterpret_cast<Slot*>(p);
+            pSlot->pSlab->pPool->Free(pSlot);
+        }
+    };
+    using Ptr = std::unique_ptr<T, Deleter>;
+
+    SlabObjectPoolT() {}
+
+    ~SlabObjectPoolT() {
+        FreeList(_pPartial);
+        FreeList(_pFull);
+    }
+
+    SlabObjectPoolT(const SlabObjectPoolT&) = delete;
+    SlabObjectPoolT& operator=(const SlabObjectPoolT&) = delete;
+
+    template <typename... Args>
+    Ptr Alloc(Args&&... args) {
+        if (!_pPartial) {
+            NewSlab();
+        }
+        Slab* pSlab = _pPartial;
+        Slot* pSlot = pSlab->pFree;
+        T* p = new (&pSlot->kStorage) T(std::forward<Args>(args)...);
+        // 构造成功后再摘下空闲槽
+        pSlab->pFree = pSlot->pNextFree;
+        pSlot->pNextFree = nullptr;
+        ++pSlab->nUsed;
+        ++_nUsed;
+        if (!pSlab->pFree) {
+            Unlink(_pPartial, pSlab);
+            LinkHead(_pFull, pSlab);
+        }
+        return Ptr(p);
+    }
+
+    // 预热, 保证至少能容纳 nCount 个对象而不再申请内存
+    void Reserve(size_t nCount) {
+        while (_nSlabs * N < nCount) {
+            NewSlab();
+        }
+    }
+
+    // 释放空闲的块, 最多保留 nKeepSlabs 个空块; 返回释放的块数
+    size_t Trim(size_t nKeepSlabs = 0) {
+        size_t nKept = 0;
+        size_t nFreed = 0;
+        Slab* pSlab = _pPartial;
+        while (pSlab) {
+            Slab* pNext = pSlab->pNext;
+            if (pSlab->nUsed == 0) {
+                if (nKept < nKeepSlabs) {
+                    ++nKept;
+                } else {
+                    Unlink(_pPartial, pSlab);
+                    delete pSlab;
+                    --_nSlabs;
+                    ++nFreed;
+                }
+            }
+            pSlab = pNext;
+        }
+        return nFreed;
+    }
+
+    // 使用中的对象数
+    size_t Size() const {
+        return _nUsed;
+    }
+
+    // 已申请的槽数
+    size_t Capacity() const {
+        return _nSlabs * N;
+    }
+
+  private:
+    struct Slot {
+        // T 必须是第一个成员, 由 T* 找回 Slot
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type kStorage;
+        Slot* pNextFree = nullptr;
+        Slab* pSlab = nullptr;
+    };
+
+    struct Slab {
+        Slab* pPrev = nullptr;
+        Slab* pNext = nullptr;
+        Slot* pFree = nullptr;
+        size_t nUsed = 0;
+        SlabObjectPoolT* pPool = nullptr;
+        Slot kSlots[N];
+
+        explicit Slab(SlabObjectPoolT* p)
+            : pPool(p) {
+            for (size_t i = N; i > 0; i--) {
+                kSlots[i - 1].pSlab = this;
+                kSlots[i - 1].pNextFree = pFree;
+                pFree = &kSlots[i - 1];
+            }
+        }
+    };
+
+    void NewSlab() {
+        Slab* pSlab = new Slab(this);
+        LinkHead(_pPartial, pSlab);
+        ++_nSlabs;
+    }
+
+    void Free(Slot* pSlot) {
+        reinterpret_cast<T*>(&pSlot->kStorage)->~T();
+        Slab* pSlab = pSlot->pSlab;
+        bool bWasFull = pSlab->pFree == nullptr;
+        pSlot->pNextFree = pSlab->pFree;
+        pSlab->pFree = pSlot;
+        --pSlab->nUsed;
+        --_nUsed;
+        if (bWasFull) {
+            Unlink(_pFull, pSlab);
+            LinkHead(_pPartial, pSlab);
+        }
+    }
+
+    static void LinkHead(Slab*& pHead, Slab* pSlab) {
+        pSlab->pPrev = nullptr;
+        pSlab->pNext = pHead;
+        if (pHead) {
+            pHead->pPrev = pSlab;
+        }
+        pHead = pSlab;
+    }
+
+    static void Unlink(Slab*& pHead, Slab* pSlab) {
+        if (pSlab->pPrev) {
+            pSlab->pPrev->pNext = pSlab->pNext;
+        } else {
+            pHead = pSlab->pNext;
+        }
+        if (pSlab->pNext) {
+            pSlab->pNext->pPrev = pSlab->pPrev;
+        }
+        pSlab->pPrev = nullptr;
+        pSlab->pNext = nullptr;
+    }
+
+    static void FreeList(Slab*& pHead) {
+        while (pHead) {
+            Slab* pNext = pHead->pNext;
+            delete pHead;
+            pHead = pNext;
+        }
+    }
+
+    Slab* _pPartial = nullptr;
+    Slab* _pFull = nullptr;
+    size_t _nSlabs = 0;
+    size_t _nUsed = 0;
+};
+
+// 线程安全的对象池, 可跨线程共享
+// 每个线程持有两个弹匣(每个最多 M 个对象)作为本地缓存, 分配与归还大多不触及共享数据;
+// 本地缓存满或空时与全局仓库整匣交换, 仓库是无锁环形缓冲, 最多 D 个满弹匣
+// 对象可在任意线程释放, 归还到释放线程的本地缓存
+template <typename T, size_t M = 32, size_t D = 64>
+class ConcurrentObjectPoolT {
+    struct Core;
+
+  public:
+    using ClearFunc = std::function<void(T&)>;
+
+    // 只记录所属的池, 不持有引用计数
+    struct Deleter {
+        Core* pCore = nullptr;
+
+        void operator()(T* p) const {
+            pCore->Put(p);
+        }
+    };
+    using UniqueHandle = std::unique_ptr<T, Deleter>;
+
+    ConcurrentObjectPoolT()
+        : _pCore(std::make_shared<Core>()) {
+    }
+
+    ConcurrentObjectPoolT(ClearFunc clear)
+        : _pCore(std::make_shared<Core>()) {
+        _pCore->fnCleaner = std::move(clear);
+    }
+
+    ConcurrentObjectPoolT(const ConcurrentObjectPoolT&) = delete;
+    ConcurrentObjectPoolT& operator=(const ConcurrentObjectPoolT&) = delete;
+
+    // 返回的对象持有池的引用, 可以比池活得更久
+    // 每次分配一个 shared_ptr 控制块, 并对池的引用计数做一次原子加减, 多线程高频分配时用 AllocUnique
+    std::shared_ptr<T> Alloc() {
+        std::shared_ptr<Core> pCore = _pCore;
+        T* res = pCore->Get();
+        return std::shared_ptr<T>(res, [pCore = std::move(pCore)](T* p) {
+            pCore->Put(p);
+        });
+    }
+
+    // 不分配内存也不触及共享计数, 池预热后只访问线程本地缓存; 句柄不能比池活得更久
+    UniqueHandle AllocUnique() {
+        Core* pCore = _pCore.get();
+        return UniqueHandle(pCore->Get(), Deleter{pCore});
+    }
+
+    // 仓库中缓存的对象数, 不含各线程本地缓存, 近似值
+    size_t Size() const {
+        return _pCore->kDepot.Size() * M;
+    }
+
+  private:
+    struct Magazine {
+        size_t nCount = 0;
+        T* pObjects[M];
+
+        bool Empty() const {
+            return nCount == 0;
+        }
+
+        bool Full() const {
+            return nCount == M;
+        }
+
+        void FreeAll() {
+            while (nCount > 0) {
+                delete pObjects[--nCount];
+            }
+        }
+    };
+
+    // 线程本地缓存中的一项, 对应一个池
+    struct LocalEntry {
+        uint64_t nId = 0;
+        std::weak_ptr<Core> wpCore;
+        Magazine* pLoaded = nullptr;
+        Magazine* pPrevious = nullptr;
+
+        // 池还在时弹匣交还仓库, 否则直接释放
+        void Release() {
+            std::shared_ptr<Core> pCore = wpCore.lock();
+            for (Magazine* pMag : {pLoaded, pPrevious}) {
+                if (!pMag) {
+                    continue;
+                }
+                if (pCore) {
+                    pCore->PutMagazine(pMag);
+                } else {
+                    pMag->FreeAll();
+                    delete pMag;
+                }
+            }
+            pLoaded = nullptr;
+            pPrevious = nullptr;
+        }
+    };
+
+    struct LocalCache {
+        std::vector<LocalEntry> vecEntry;
+        size_t nLast = 0;
+
+        ~LocalCache() {
+            Exiting() = true;
+            for (auto& kEntry : vecEntry) {
+                kEntry.Release();
+            }
+        }
+
+        LocalEntry& Find(Core* pCore) {
+            if (nLast < vecEntry.size() && vecEntry[nLast].nId == pCore->nId) {
+                return vecEntry[nLast];
+            }
+            for (size_t i = 0; i < vecEntry.size(); i++) {
+                if (vecEntry[i].nId == pCore->nId) {
+                    nLast = i;
+                    return vecEntry[i];
+                }
+            }
+            // 顺便清理已销毁的池
+            for (size_t i = 0; i < vecEntry.size();) {
+                if (vecEntry[i].wpCore.expired()) {
+                    vecEntry[i].Release();
+                    vecEntry[i] = std::move(vecEntry.back());
+                    vecEntry.pop_back();
+                } else {
+                    i++;
+                }
+            }
+            LocalEntry kEntry;
+            kEntry.nId = pCore->nId;
+            kEntry.wpCore = pCore->weak_from_this();
+            kEntry.pLoaded = new Magazine;
+            kEntry.pPrevious = new Magazine;
+            vecEntry.emplace_back(std::move(kEntry));
+            nLast = vecEntry.size() - 1;
+            return vecEntry.back();
+        }
+    };
+
+    // 线程退出时本地缓存已销毁, 之后的分配与归还直接走 new/delete
+    static bool& Exiting() {
+        static thread_local bool bExiting = false;
+        return bExiting;
+    }
+
+    static LocalCache& Local() {
+        static thread_local LocalCache kCache;
+        return kCache;
+    }
+
+    struct Core : std::enable_shared_from_this<Core> {
+        // 池的唯一编号, 区分地址被复用的池
+        uint64_t nId = NextId();
+        ClearFunc fnCleaner = nullptr;
+        // 满弹匣
+        RingBuffer<Magazine*, D> kDepot;
+        // 空弹匣, 避免反复申请
+        RingBuffer<Magazine*, D> kEmpty;
+
+        ~Core() {
+            Magazine* pMag = nullptr;
+            while (kDepot.TryPop(pMag)) {
+                pMag->FreeAll();
+                delete pMag;
+            }
+            while (kEmpty.TryPop(pMag)) {
+                delete pMag;
+            }
+        }
+
+        static uint64_t NextId() {
+            static std::atomic<uint64_t> nNext = {1};
+            return nNext.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        T* Get() {
+            if (Exiting()) {
+                return new T;
+            }
+            LocalEntry& kEntry = Local().Find(this);
+            Magazine*& pLoaded = kEntry.pLoaded;
+            Magazine*& pPrevious = kEntry.pPrevious;
+            if (pLoaded->Empty()) {
+                if (!pPrevious->Empty()) {
+                    std::swap(pLoaded, pPrevious);
+                } else {
+                    Magazine* pFull = nullptr;
+                    if (!kDepot.TryPop(pFull)) {
+                        return new T;
+                    }
+                    PutEmpty(pPrevious);
+                    pPrevious = pLoaded;
+                    pLoaded = pFull;
+                }
+            }
+            return pLoaded->pObjects[--pLoaded->nCount];
+        }
+
+        void Put(T* p) {
+            if (fnCleaner) {
+                fnCleaner(*p);
+            }
+            if (Exiting()) {
+                delete p;
+                return;
+            }
+            LocalEntry& kEntry = Local().Find(this);
+            Magazine*& pLoaded = kEntry.pLoaded;
+            Magazine*& pPrevious = kEntry.pPrevious;
+            if (pLoaded->Full()) {
+                if (!pPrevious->Full()) {
+                    std::swap(pLoaded, pPrevious);
+                } else {
+                    Magazine* pEmpty = GetEmpty();
+                    PutMagazine(pPrevious);
+                    pPrevious = pLoaded;
+                    pLoaded = pEmpty;
+                }
+            }
+            pLoaded->pObjects[pLoaded->nCount++] = p;
+        }
+
+        // 非空弹匣放入仓库, 仓库满时释放其中的对象
+        void PutMagazine(Magazine* pMag) {
+            if (pMag->Empty()) {
+                PutEmpty(pMag);
+                return;
+            }
+            if (!kDepot.TryEmplace(pMag)) {
+                pMag->FreeAll();
+                PutEmpty(pMag);
+            }
+        }
+
+        Magazine* GetEmpty() {
+            Magazine* pMag = nullptr;
+            if (kEmpty.TryPop(pMag)) {
+                return pMag;
+            }
+            return new Magazine;
+        }
+
+        void PutEmpty(Magazine* pMag) {
+            if (!kEmpty.TryEmplace(pMag)) {
+                delete pMag;
+            }
+        }
+    };
+
+    std::shared_ptr<Core> _pCore;
+};
+} // namespace xs
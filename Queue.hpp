@@ -2,23 +2,93 @@
 
 #include <queue>
 #include <mutex>
+#include <optional>
+#include <vector>
+#include <iterator>
 
 #include "Signal.hpp"
+#include "Coroutine.hpp"
 
 namespace xs {
 template <typename T>
 class Queue {
   public:
     bool Push(const T& t) {
-        std::lock_guard<std::mutex> kLock(_lock);
-        _queue.push(t);
-        _signal.Notify();
+        return Emplace(t);
+    }
+
+    bool Push(T&& t) {
+        return Emplace(std::move(t));
+    }
+
+    template <typename... Args>
+    bool Emplace(Args&&... args) {
+        Waiter* pWaiter = nullptr;
+        {
+            std::lock_guard<std::mutex> kLock(_lock);
+            pWaiter = PopWaiter();
+            if (pWaiter) {
+                // 有异步等待者时直接交给它, 不入队
+                pWaiter->kValue.emplace(std::forward<Args>(args)...);
+            } else {
+                _queue.emplace(std::forward<Args>(args)...);
+                _signal.Notify();
+            }
+        }
+        if (pWaiter) {
+            pWaiter->fnWake(pWaiter);
+        }
+        return true;
+    }
+
+    // 一次加锁写入 [first, last), 只唤醒一次
+    // 传入 std::make_move_iterator 可避免拷贝
+    template <typename It>
+    bool PushBatch(It first, It last) {
+        int32_t nCount = 0;
+        Waiter* pWakeHead = nullptr;
+        Waiter* pWakeTail = nullptr;
+        {
+            std::lock_guard<std::mutex> kLock(_lock);
+            for (; first != last; ++first) {
+                Waiter* pWaiter = PopWaiter();
+                if (pWaiter) {
+                    pWaiter->kValue.emplace(*first);
+                    if (pWakeTail) {
+                        pWakeTail->pNext = pWaiter;
+                    } else {
+                        pWakeHead = pWaiter;
+                    }
+                    pWakeTail = pWaiter;
+                    continue;
+                }
+                _queue.push(*first);
+                ++nCount;
+            }
+            if (nCount > 0) {
+                _signal.Notify(nCount);
+            }
+        }
+        while (pWakeHead) {
+            Waiter* pNext = pWakeHead->pNext;
+            pWakeHead->fnWake(pWakeHead);
+            pWakeHead = pNext;
+        }
         return true;
     }
 
+    // _signal 的计数与队列元素数一致: 入队在锁内 Notify, 非阻塞出队在锁内 TryWait
+    // 取到的信号对应的元素可能被非阻塞出队抢走(对方 TryWait 失败), 此时继续等待
     bool WaitPop(T& t) {
-        _signal.Wait();
-        return Pop(t);
+        while (true) {
+            _signal.Wait();
+            std::lock_guard<std::mutex> kLock(_lock);
+            if (!_queue.empty()) {
+                t = std::move(_queue.front());
+                _queue.pop();
+                return true;
+            }
+        }
     }
 
     bool Pop(T& t) {
@@ -28,23 +98,127 @@ class Queue {
         }
         t = std::move(_queue.front());
         _queue.pop();
+        _signal.TryWait();
         return true;
     }
 
+    // 一次加锁最多取出 nMax 个追加到 vec, 返回取出个数, 不阻塞
+    size_t PopBatch(std::vector<T>& vec, size_t nMax) {
+        std::lock_guard<std::mutex> kLock(_lock);
+        size_t nCount = 0;
+        while (nCount < nMax && !_queue.empty()) {
+            vec.emplace_back(std::move(_queue.front()));
+            _queue.pop();
+            _signal.TryWait();
+            ++nCount;
+        }
+        return nCount;
+    }
+
+#ifdef XS_HAS_COROUTINE
+    // T t = co_await queue.PopAsync();
+    // 队列为空时挂起, 由下一次 Push 的线程恢复协程
+    auto PopAsync() {
+        struct PopAwaiter : Waiter {
+            Queue* pQueue;
+            std::coroutine_handle<> hWaiter;
+
+            explicit PopAwaiter(Queue* p)
+                : pQueue(p) {
+                this->fnWake = [](Waiter* pWaiter) {
+                    static_cast<PopAwaiter*>(pWaiter)->hWaiter.resume();
+                };
+            }
+
+            bool await_ready() {
+                return pQueue->TryTake(*this);
+            }
+
+            bool await_suspend(std::coroutine_handle<> h) {
+                hWaiter = h;
+                return pQueue->TakeOrWait(*this);
+            }
+
+            T await_resume() {
+                return std::move(*this->kValue);
+            }
+        };
+        return PopAwaiter(this);
+    }
+#endif
+
     int Size() const {
         std::lock_guard<std::mutex> kLock(_lock);
         return _queue.size();
     }
 
+    // 供 Selector 监视队列是否有数据
+    void SetObserver(SignalObserver* pObserver) {
+        _signal.SetObserver(pObserver);
+    }
+
     void Clear() {
         std::lock_guard<std::mutex> kLock(_lock);
+        for (size_t i = _queue.size(); i > 0; i--) {
+            _signal.TryWait();
+        }
         std::queue<T> _temp;
         _queue.swap(_temp);
     }
 
   private:
+    // 异步等待者, 由 PopAsync 创建, 按先后顺序排队
+    struct Waiter {
+        Waiter* pNext = nullptr;
+        std::optional<T> kValue;
+        void (*fnWake)(Waiter*) = nullptr;
+    };
+
+    Waiter* PopWaiter() {
+        Waiter* pWaiter = _pWaitHead;
+        if (pWaiter) {
+            _pWaitHead = pWaiter->pNext;
+            if (!_pWaitHead) {
+                _pWaitTail = nullptr;
+            }
+            pWaiter->pNext = nullptr;
+        }
+        return pWaiter;
+    }
+
+    bool TryTake(Waiter& kWaiter) {
+        std::lock_guard<std::mutex> kLock(_lock);
+        if (_queue.empty()) {
+            return false;
+        }
+        kWaiter.kValue.emplace(std::move(_queue.front()));
+        _queue.pop();
+        _signal.TryWait();
+        return true;
+    }
+
+    // 返回 true 表示已登记等待
+    bool TakeOrWait(Waiter& kWaiter) {
+        std::lock_guard<std::mutex> kLock(_lock);
+        if (!_queue.empty()) {
+            kWaiter.kValue.emplace(std::move(_queue.front()));
+            _queue.pop();
+            _signal.TryWait();
+            return false;
+        }
+        if (_pWaitTail) {
+            _pWaitTail->pNext = &kWaiter;
+        } else {
+            _pWaitHead = &kWaiter;
+        }
+        _pWaitTail = &kWaiter;
+        return true;
+    }
+
     std::queue<T> _queue;
     Signal _signal;
-    std::mutex _lock;
+    mutable std::mutex _lock;
+    Waiter* _pWaitHead = nullptr;
+    Waiter* _pWaitTail = nullptr;
 };
-} // namespace xs
\ No newline at end of file
+} // namespace xs
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Signal.hpp"
+
+namespace xs {
+
+#ifndef XS_CACHELINE_SIZE
+#define XS_CACHELINE_SIZE 64
+#endif
+
+// 有界无锁多生产者多消费者环形缓冲, N 必须是 2 的幂
+// 算法: http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+template <typename T, size_t N>
+class RingBuffer {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "RingBuffer size must be power of 2");
+
+  public:
+    RingBuffer()
+        : _cells(new Cell[N]) {
+        for (size_t i = 0; i < N; i++) {
+            _cells[i].nSeq.store(i, std::memory_order_relaxed);
+        }
+        _nEnqueuePos.store(0, std::memory_order_relaxed);
+        _nDequeuePos.store(0, std::memory_order_relaxed);
+    }
+
+    ~RingBuffer() {
+        size_t nEnd = _nEnqueuePos.load(std::memory_order_relaxed);
+        for (size_t nPos = _nDequeuePos.load(std::memory_order_relaxed); nPos != nEnd; nPos++) {
+            Cell& kCell = _cells[nPos & (N - 1)];
+            if (kCell.nSeq.load(std::memory_order_relaxed) == nPos + 1) {
+                kCell.Data()->~T();
+            }
+        }
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    template <typename... Args>
+    bool TryEmplace(Args&&... args) {
+        Cell* pCell = nullptr;
+        size_t nPos = _nEnqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            pCell = &_cells[nPos & (N - 1)];
+            size_t nSeq = pCell->nSeq.load(std::memory_order_acquire);
+            intptr_t nDiff = (intptr_t)nSeq - (intptr_t)nPos;
+            if (nDiff == 0) {
+                if (_nEnqueuePos.compare_exchange_weak(nPos, nPos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (nDiff < 0) {
+                // 已满
+                return false;
+            } else {
+                nPos = _nEnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        new (pCell->Data()) T(std::forward<Args>(args)...);
+        pCell->nSeq.store(nPos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPop(T& t) {
+        size_t nPos = 0;
+        Cell* pCell = ClaimHead(nPos);
+        if (!pCell) {
+            return false;
+        }
+        T* pData = pCell->Data();
+        t = std::move(*pData);
+        pData->~T();
+        pCell->nSeq.store(nPos + N, std::memory_order_release);
+        return true;
+    }
+
+    // 取出并直接析构队首元素, 不要求 T 可默认构造
+    bool TryDiscard() {
+        size_t nPos = 0;
+        Cell* pCell = ClaimHead(nPos);
+        if (!pCell) {
+            return false;
+        }
+        pCell->Data()->~T();
+        pCell->nSeq.store(nPos + N, std::memory_order_release);
+        return true;
+    }
+
+    // 并发时只是近似值
+    size_t Size() const {
+        size_t nDeq = _nDequeuePos.load(std::memory_order_relaxed);
+        size_t nEnq = _nEnqueuePos.load(std::memory_order_relaxed);
+        return nEnq > nDeq ? nEnq - nDeq : 0;
+    }
+
+    static constexpr size_t Capacity() {
+        return N;
+    }
+
+  private:
+    struct Cell {
+        std::atomic<size_t> nSeq;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type kData;
+
+        T* Data() {
+            return reinterpret_cast<T*>(&kData);
+        }
+    };
+
+    // 占有队首已发布的格子, 队首为空或尚未发布时返回 nullptr
+    Cell* ClaimHead(size_t& nPos) {
+        nPos = _nDequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell* pCell = &_cells[nPos & (N - 1)];
+            size_t nSeq = pCell->nSeq.load(std::memory_order_acquire);
+            intptr_t nDiff = (intptr_t)nSeq - (intptr_t)(nPos + 1);
+            if (nDiff == 0) {
+                if (_nDequeuePos.compare_exchange_weak(nPos, nPos + 1, std::memory_order_relaxed)) {
+                    return pCell;
+                }
+            } else if (nDiff < 0) {
+                // 为空
+                return nullptr;
+            } else {
+                nPos = _nDequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::unique_ptr<Cell[]> _cells;
+    // 生产者与消费者的游标各占一条缓存行, 避免伪共享
+    alignas(XS_CACHELINE_SIZE) std::atomic<size_t> _nEnqueuePos;
+    alignas(XS_CACHELINE_SIZE) std::atomic<size_t> _nDequeuePos;
+};
+
+// 与 Queue 接口一致的有界无锁队列, 满时 Push 返回 false
+template <typename T, size_t N = 1024>
+class RingQueue {
+  public:
+    bool Push(const T& t) {
+        return Emplace(t);
+    }
+
+    bool Push(T&& t) {
+        return Emplace(std::move(t));
+    }
+
+    template <typename... Args>
+    bool Emplace(Args&&... args) {
+        if (!_buffer.TryEmplace(std::forward<Args>(args)...)) {
+            return false;
+        }
+        _signal.Notify();
+        return true;
+    }
+
+    // 信号数不超过已发布的元素数, 出队前先取一个信号
+    // 取到信号后队首可能是已占位但还没发布的格子(其后的格子先发布), 自旋等它发布
+    bool WaitPop(T& t) {
+        _signal.Wait();
+        while (!_buffer.TryPop(t)) {
+            CpuRelax();
+        }
+        return true;
+    }
+
+    bool Pop(T& t) {
+        if (!_signal.TryWait()) {
+            return false;
+        }
+        while (!_buffer.TryPop(t)) {
+            CpuRelax();
+        }
+        return true;
+    }
+
+    int Size() const {
+        return (int)_buffer.Size();
+    }
+
+    // 供 Selector 监视队列是否有数据
+    void SetObserver(SignalObserver* pObserver) {
+        _signal.SetObserver(pObserver);
+    }
+
+    void Clear() {
+        while (_signal.TryWait()) {
+            while (!_buffer.TryDiscard()) {
+                CpuRelax();
+            }
+        }
+    }
+
+  private:
+    RingBuffer<T, N> _buffer;
+    Signal _signal;
+};
+} // namespace xs
@@ -0,0 +1,195 @@
+#pragma once
+
+// 同时等待多个 Signal/Queue/文件描述符, 返回就绪的项
+// 基于 epoll + eventfd, 仅 Linux 可用
+
+#ifdef __linux__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "Signal.hpp"
+
+namespace xs {
+
+// Selector kSel;
+// kSel.Add(queue, 1); kSel.Add(kStopSignal, 2); kSel.AddFd(nSocket, EPOLLIN, 3);
+// std::vector<int> vecReady;
+// kSel.WaitFor(vecReady, std::chrono::milliseconds(100));
+//
+// 水平触发: 只报告就绪, 不取走数据或信号, 由调用者自己 Pop/TryWait
+// 每个 Signal/Queue 同时只能被一个 Selector 监视, Selector 销毁前要先 Remove 或保证它们不再 Notify
+// 非线程安全: Add/AddFd/Remove/Wait/WaitFor 只能在同一个线程上调用, 只有 OnNotify 可以来自其它线程
+// 多个线程各自等待时, 每个线程用自己的 Selector
+class Selector : public SignalObserver {
+  public:
+    Selector() {
+        _nEpollFd = epoll_create1(EPOLL_CLOEXEC);
+        _nEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (_nEpollFd >= 0 && _nEventFd >= 0) {
+            epoll_event kEvent = {};
+            kEvent.events = EPOLLIN;
+            kEvent.data.u64 = kWakeTag;
+            epoll_ctl(_nEpollFd, EPOLL_CTL_ADD, _nEventFd, &kEvent);
+        }
+    }
+
+    ~Selector() {
+        for (auto& kEntry : _vecEntry) {
+            if (kEntry.fnObserve) {
+                kEntry.fnObserve(nullptr);
+            }
+        }
+        if (_nEventFd >= 0) {
+            close(_nEventFd);
+        }
+        if (_nEpollFd >= 0) {
+            close(_nEpollFd);
+        }
+    }
+
+    Selector(const Selector&) = delete;
+    Selector& operator=(const Selector&) = delete;
+
+    bool Valid() const {
+        return _nEpollFd >= 0 && _nEventFd >= 0;
+    }
+
+    // 有可用信号时就绪
+    void Add(Signal& kSignal, int nId) {
+        Signal* pSignal = &kSignal;
+        AddEntry(nId, [pSignal]() { return pSignal->Count() > 0; }, [pSignal](SignalObserver* p) { pSignal->SetObserver(p); });
+    }
+
+    // 队列非空时就绪, 支持 Queue/RingQueue
+    template <typename TQueue>
+    void Add(TQueue& kQueue, int nId) {
+        TQueue* pQueue = &kQueue;
+        AddEntry(nId, [pQueue]() { return pQueue->Size() > 0; }, [pQueue](SignalObserver* p) { pQueue->SetObserver(p); });
+    }
+
+    // 监视文件描述符, nEvents 为 EPOLLIN/EPOLLOUT 等
+    bool AddFd(int nFd, uint32_t nEvents, int nId) {
+        epoll_event kEvent = {};
+        kEvent.events = nEvents;
+        kEvent.data.u64 = (uint64_t)(uint32_t)nId;
+        return epoll_ctl(_nEpollFd, EPOLL_CTL_ADD, nFd, &kEvent) == 0;
+    }
+
+    bool RemoveFd(int nFd) {
+        return epoll_ctl(_nEpollFd, EPOLL_CTL_DEL, nFd, nullptr) == 0;
+    }
+
+    void Remove(int nId) {
+        for (size_t i = 0; i < _vecEntry.size(); i++) {
+            if (_vecEntry[i].nId == nId) {
+                _vecEntry[i].fnObserve(nullptr);
+                _vecEntry.erase(_vecEntry.begin() + i);
+                return;
+            }
+        }
+    }
+
+    // 阻塞到至少一项就绪, 返回就绪个数, 就绪的 id 写入 vecReady
+    size_t Wait(std::vector<int>& vecReady) {
+        for (;;) {
+            size_t n = Select(vecReady, -1);
+            if (n > 0) {
+                return n;
+            }
+        }
+    }
+
+    // 超时返回 0
+    template <typename Rep, typename Period>
+    size_t WaitFor(std::vector<int>& vecReady, const std::chrono::duration<Rep, Period>& d) {
+        auto tpDeadline = std::chrono::steady_clock::now() + d;
+        for (;;) {
+            auto nLeft = std::chrono::ceil<std::chrono::milliseconds>(tpDeadline - std::chrono::steady_clock::now());
+            int nTimeout = nLeft.count() < 0 ? 0 : (int)nLeft.count();
+            size_t n = Select(vecReady, nTimeout);
+            if (n > 0 || nTimeout == 0) {
+                return n;
+            }
+        }
+    }
+
+    // Signal/Queue 被 Notify 时调用, 只在 Selector 等待中才写 eventfd
+    void OnNotify() override {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_bWaiting.load(std::memory_order_relaxed)) {
+            uint64_t n = 1;
+            ssize_t nRet = write(_nEventFd, &n, sizeof(n));
+            (void)nRet;
+        }
+    }
+
+  private:
+    static constexpr uint64_t kWakeTag = ~0ull;
+    static constexpr int kMaxEvents = 64;
+
+    struct Entry {
+        int nId;
+        std::function<bool()> fnReady;
+        std::function<void(SignalObserver*)> fnObserve;
+    };
+
+    void AddEntry(int nId, std::function<bool()> fnReady, std::function<void(SignalObserver*)> fnObserve) {
+        fnObserve(this);
+        _vecEntry.push_back(Entry{nId, std::move(fnReady), std::move(fnObserve)});
+    }
+
+    void CollectReady(std::vector<int>& vecReady) {
+        for (auto& kEntry : _vecEntry) {
+            if (kEntry.fnReady()) {
+                vecReady.push_back(kEntry.nId);
+            }
+        }
+    }
+
+    // 一次等待, nTimeoutMs < 0 无限等待; 被唤醒但没有就绪项(被其它消费者取走)时继续等
+    size_t Select(std::vector<int>& vecReady, int nTimeoutMs) {
+        vecReady.clear();
+        CollectReady(vecReady);
+        if (!vecReady.empty()) {
+            return vecReady.size();
+        }
+
+        _bWaiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // 登记等待后再检查一次, 避免错过登记前的 Notify
+        CollectReady(vecReady);
+        if (vecReady.empty()) {
+            epoll_event kEvents[kMaxEvents];
+            int nCount = epoll_wait(_nEpollFd, kEvents, kMaxEvents, nTimeoutMs);
+            for (int i = 0; i < nCount; i++) {
+                if (kEvents[i].data.u64 == kWakeTag) {
+                    uint64_t n = 0;
+                    ssize_t nRet = read(_nEventFd, &n, sizeof(n));
+                    (void)nRet;
+                } else {
+                    vecReady.push_back((int)(uint32_t)kEvents[i].data.u64);
+                }
+            }
+            CollectReady(vecReady);
+        }
+        _bWaiting.store(false, std::memory_order_relaxed);
+        return vecReady.size();
+    }
+
+    int _nEpollFd = -1;
+    int _nEventFd = -1;
+    std::atomic<bool> _bWaiting = {false};
+    std::vector<Entry> _vecEntry;
+};
+} // namespace xs
+
+#endif
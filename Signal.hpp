@@ -1,43 +1,251 @@
 #pragma once
 
-#include <mutex>
-#include <condition_variable>
 #include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <thread>
+
+#ifdef __linux__
+#include <cerrno>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
 
 namespace xs {
-class Signal final {
+
+// 自旋等待时让出流水线
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+namespace detail {
+// 只负责睡眠与唤醒的底层信号量, 仅在确实有线程需要睡眠时使用
+class ParkSemaphore {
   public:
-    Signal()
-        : _cargo(0) {
+#ifdef __linux__
+    void Wait() {
+        while (!TryTake()) {
+            Futex(FUTEX_WAIT_PRIVATE, 0, nullptr);
+        }
+    }
+
+    // 超时返回 false
+    bool WaitUntil(std::chrono::steady_clock::time_point tpDeadline) {
+        while (!TryTake()) {
+            auto nLeft = tpDeadline - std::chrono::steady_clock::now();
+            if (nLeft <= nLeft.zero()) {
+                return false;
+            }
+            auto nSec = std::chrono::duration_cast<std::chrono::seconds>(nLeft);
+            timespec ts;
+            ts.tv_sec = (time_t)nSec.count();
+            ts.tv_nsec = (long)std::chrono::duration_cast<std::chrono::nanoseconds>(nLeft - nSec).count();
+            Futex(FUTEX_WAIT_PRIVATE, 0, &ts);
+        }
+        return true;
+    }
+
+    void Post(int32_t n) {
+        _nWakes.fetch_add((uint32_t)n, std::memory_order_release);
+        Futex(FUTEX_WAKE_PRIVATE, n, nullptr);
+    }
+
+  private:
+    bool TryTake() {
+        uint32_t n = _nWakes.load(std::memory_order_relaxed);
+        while (n > 0) {
+            if (_nWakes.compare_exchange_weak(n, n - 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    long Futex(int nOp, uint32_t nVal, const timespec* pTimeout) {
+        return syscall(SYS_futex, reinterpret_cast<uint32_t*>(&_nWakes), nOp, nVal, pTimeout, nullptr, 0);
     }
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex needs a plain 32-bit word");
+    std::atomic<uint32_t> _nWakes = {0};
+#else
     void Wait() {
         std::unique_lock<std::mutex> kLock(_lock);
         _condition.wait(kLock, [this]() -> bool {
-            return _cargo > 0;
+            return _nWakes > 0;
         });
-        --_cargo;
+        --_nWakes;
     }
 
-    bool WaitFor(std::chrono::milliseconds d) {
+    bool WaitUntil(std::chrono::steady_clock::time_point tpDeadline) {
         std::unique_lock<std::mutex> kLock(_lock);
-        bool ok = _condition.wait_for(kLock, d, [this]() -> bool {
-            return _cargo > 0;
+        bool ok = _condition.wait_until(kLock, tpDeadline, [this]() -> bool {
+            return _nWakes > 0;
         });
         if (ok) {
-            --_cargo;
+            --_nWakes;
         }
         return ok;
     }
 
-    void Notify() {
+    void Post(int32_t n) {
         std::lock_guard<std::mutex> kLock(_lock);
-        ++_cargo;
-        _condition.notify_one();
+        _nWakes += n;
+        if (n == 1) {
+            _condition.notify_one();
+        } else {
+            _condition.notify_all();
+        }
     }
 
-  protected:
+  private:
     std::mutex _lock;
-    std::atomic<int32_t> _cargo;
     std::condition_variable _condition;
+    int32_t _nWakes = 0;
+#endif
+};
+} // namespace detail
+
+// Signal 被 Notify 后的回调, 用于 Selector 同时等待多个 Signal
+// 在 Notify 的线程上调用, 需要足够轻量
+class SignalObserver {
+  public:
+    virtual ~SignalObserver() {}
+    virtual void OnNotify() = 0;
+};
+
+// 计数信号量
+// _cargo > 0 为可用信号数, < 0 为睡眠中的线程数
+// Notify 没有等待者时只有一次原子加; Wait 先自旋, 确实等不到才睡眠
+class Signal final {
+  public:
+    Signal()
+        : _cargo(0) {
+    }
+
+    void Wait() {
+        if (TryWait() || SpinWait()) {
+            return;
+        }
+        if (_cargo.fetch_sub(1, std::memory_order_acquire) > 0) {
+            return;
+        }
+        _park.Wait();
+    }
+
+    // 不阻塞, 有信号时取走一个
+    bool TryWait() {
+        int32_t n = _cargo.load(std::memory_order_relaxed);
+        while (n > 0) {
+            if (_cargo.compare_exchange_weak(n, n - 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <typename Rep, typename Period>
+    bool WaitFor(const std::chrono::duration<Rep, Period>& d) {
+        if (TryWait()) {
+            return true;
+        }
+        if (d <= d.zero()) {
+            return false;
+        }
+        auto tpDeadline = std::chrono::steady_clock::now() + std::chrono::ceil<std::chrono::steady_clock::duration>(d);
+        if (SpinWait()) {
+            return true;
+        }
+        if (_cargo.fetch_sub(1, std::memory_order_acquire) > 0) {
+            return true;
+        }
+        if (_park.WaitUntil(tpDeadline)) {
+            return true;
+        }
+        // 超时, 撤销等待登记; 若已被 Notify 计入唤醒, 必须把对应的唤醒取走
+        int32_t n = _cargo.load(std::memory_order_relaxed);
+        while (n < 0) {
+            if (_cargo.compare_exchange_weak(n, n + 1, std::memory_order_relaxed)) {
+                return false;
+            }
+        }
+        _park.Wait();
+        return true;
+    }
+
+    void Notify() {
+        if (_cargo.fetch_add(1, std::memory_order_release) < 0) {
+            _park.Post(1);
+        }
+        NotifyObserver();
+    }
+
+    // 一次增加 n 个信号
+    void Notify(int32_t n) {
+        if (n <= 0) {
+            return;
+        }
+        int32_t nOld = _cargo.fetch_add(n, std::memory_order_release);
+        if (nOld < 0) {
+            _park.Post(-nOld < n ? -nOld : n);
+        }
+        NotifyObserver();
+    }
+
+    // 当前可用的信号数, 小于等于 0 表示没有
+    int32_t Count() const {
+        return _cargo.load(std::memory_order_acquire);
+    }
+
+    // 每个 Signal 只能有一个观察者, 传 nullptr 取消
+    void SetObserver(SignalObserver* pObserver) {
+        _pObserver.store(pObserver, std::memory_order_release);
+    }
+
+  protected:
+    void NotifyObserver() {
+        SignalObserver* pObserver = _pObserver.load(std::memory_order_acquire);
+        if (pObserver) {
+            pObserver->OnNotify();
+        }
+    }
+
+    // 自适应自旋: 最近自旋成功就多转一会, 失败就少转
+    bool SpinWait() {
+        int32_t nLimit = _nSpinLimit.load(std::memory_order_relaxed);
+        for (int32_t i = 0; i < nLimit; i++) {
+            CpuRelax();
+            if (_cargo.load(std::memory_order_relaxed) > 0 && TryWait()) {
+                if (nLimit < kMaxSpin) {
+                    _nSpinLimit.store(nLimit + kSpinStep, std::memory_order_relaxed);
+                }
+                return true;
+            }
+        }
+        if (nLimit > kMinSpin) {
+            _nSpinLimit.store(nLimit - kSpinStep, std::memory_order_relaxed);
+        }
+        return false;
+    }
+
+    static constexpr int32_t kMinSpin = 16;
+    static constexpr int32_t kMaxSpin = 1024;
+    static constexpr int32_t kSpinStep = 16;
+
+    std::atomic<int32_t> _cargo;
+    std::atomic<int32_t> _nSpinLimit = {128};
+    detail::ParkSemaphore _park;
+    std::atomic<SignalObserver*> _pObserver = {nullptr};
 };
-} // namespace xs
\ No newline at end of file
+} // namespace xs
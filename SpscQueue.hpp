@@ -0,0 +1,173 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "RingQueue.hpp"
+#include "Signal.hpp"
+
+namespace xs {
+
+// 单生产者单消费者无等待环形队列, N 必须是 2 的幂
+// Push 只能在一个线程调用, Pop 只能在另一个线程调用
+template <typename T, size_t N = 1024>
+class SpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue size must be power of 2");
+
+  public:
+    SpscQueue()
+        : _slots(new Slot[N]) {
+    }
+
+    ~SpscQueue() {
+        size_t nTail = _nTail.load(std::memory_order_relaxed);
+        for (size_t nPos = _nHead.load(std::memory_order_relaxed); nPos != nTail; nPos++) {
+            _slots[nPos & (N - 1)].Data()->~T();
+        }
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    bool Push(const T& t) {
+        return Emplace(t);
+    }
+
+    bool Push(T&& t) {
+        return Emplace(std::move(t));
+    }
+
+    template <typename... Args>
+    bool Emplace(Args&&... args) {
+        size_t nTail = _nTail.load(std::memory_order_relaxed);
+        if (nTail - _nHeadCache == N) {
+            // 缓存的 head 显示已满时才去读消费者的游标
+            _nHeadCache = _nHead.load(std::memory_order_acquire);
+            if (nTail - _nHeadCache == N) {
+                return false;
+            }
+        }
+        new (_slots[nTail & (N - 1)].Data()) T(std::forward<Args>(args)...);
+        _nTail.store(nTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Pop(T& t) {
+        size_t nHead = _nHead.load(std::memory_order_relaxed);
+        if (nHead == _nTailCache) {
+            _nTailCache = _nTail.load(std::memory_order_acquire);
+            if (nHead == _nTailCache) {
+                return false;
+            }
+        }
+        T* pData = _slots[nHead & (N - 1)].Data();
+        t = std::move(*pData);
+        pData->~T();
+        _nHead.store(nHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 并发时只是近似值
+    int Size() const {
+        size_t nTail = _nTail.load(std::memory_order_acquire);
+        size_t nHead = _nHead.load(std::memory_order_acquire);
+        return nTail > nHead ? (int)(nTail - nHead) : 0;
+    }
+
+    bool Empty() const {
+        return Size() == 0;
+    }
+
+    static constexpr size_t Capacity() {
+        return N;
+    }
+
+  private:
+    struct Slot {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type kData;
+
+        T* Data() {
+            return reinterpret_cast<T*>(&kData);
+        }
+    };
+
+    std::unique_ptr<Slot[]> _slots;
+    // 消费者的游标和它缓存的生产者游标
+    alignas(XS_CACHELINE_SIZE) std::atomic<size_t> _nHead = {0};
+    size_t _nTailCache = 0;
+    // 生产者的游标和它缓存的消费者游标
+    alignas(XS_CACHELINE_SIZE) std::atomic<size_t> _nTail = {0};
+    size_t _nHeadCache = 0;
+};
+
+// 在 SpscQueue 上增加阻塞的 WaitPop
+// 消费者先自旋, 确实没有数据才睡眠; 生产者只在消费者睡眠时才 Notify
+template <typename T, size_t N = 1024>
+class BlockingSpscQueue {
+  public:
+    bool Push(const T& t) {
+        return Emplace(t);
+    }
+
+    bool Push(T&& t) {
+        return Emplace(std::move(t));
+    }
+
+    template <typename... Args>
+    bool Emplace(Args&&... args) {
+        if (!_queue.Emplace(std::forward<Args>(args)...)) {
+            return false;
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_bWaiting.load(std::memory_order_relaxed)) {
+            _signal.Notify();
+        }
+        return true;
+    }
+
+    bool Pop(T& t) {
+        return _queue.Pop(t);
+    }
+
+    bool WaitPop(T& t) {
+        for (int i = 0; i < _nSpinCount; i++) {
+            if (_queue.Pop(t)) {
+                return true;
+            }
+            std::this_thread::yield();
+        }
+        for (;;) {
+            _bWaiting.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (_queue.Pop(t)) {
+                _bWaiting.store(false, std::memory_order_relaxed);
+                return true;
+            }
+            _signal.Wait();
+            _bWaiting.store(false, std::memory_order_relaxed);
+            if (_queue.Pop(t)) {
+                return true;
+            }
+        }
+    }
+
+    int Size() const {
+        return _queue.Size();
+    }
+
+    void SetSpinCount(int n) {
+        _nSpinCount = n;
+    }
+
+  private:
+    SpscQueue<T, N> _queue;
+    alignas(XS_CACHELINE_SIZE) std::atomic<bool> _bWaiting = {false};
+    int _nSpinCount = 64;
+    Signal _signal;
+};
+} // namespace xs
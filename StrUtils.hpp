@@ -1,9 +1,28 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <vector>
 #include <algorithm>
+#include <functional>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <system_error>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
 
 namespace xs {
 inline std::string& Trim(std::string& _str, std::string strTrim, bool _left = true, bool _right = true) {
@@ -14,11 +33,37 @@ inline std::string& Trim(std::string& _str, std::string strTrim, bool _left = tr
     return _str;
 }
 
+namespace detail {
+// 走 to_chars/from_chars 的算术类型, 字符类型按字符处理, 不在此列
+template <typename T>
+struct IsCharConvNumber : std::integral_constant<bool, std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+                                                            !std::is_same<T, char>::value && !std::is_same<T, signed char>::value &&
+                                                            !std::is_same<T, unsigned char>::value && !std::is_same<T, wchar_t>::value &&
+                                                            !std::is_same<T, char16_t>::value && !std::is_same<T, char32_t>::value> {};
+
+// 数字转成字符, 返回写入的末尾; 浮点与 ostream 默认格式一致(%g, 6 位有效数字)
+// 缓冲区 64 字节足够
+template <typename T>
+inline char* ToChars(char* pFirst, char* pLast, T p) {
+    if constexpr (std::is_floating_point<T>::value) {
+        return std::to_chars(pFirst, pLast, p, std::chars_format::general, 6).ptr;
+    } else {
+        return std::to_chars(pFirst, pLast, p).ptr;
+    }
+}
+} // namespace detail
+
 template <typename T>
 inline std::string ToString(T p) {
-    std::ostringstream stream;
-    stream << p;
-    return stream.str();
+    if constexpr (detail::IsCharConvNumber<T>::value) {
+        char szBuf[64];
+        char* pEnd = detail::ToChars(szBuf, szBuf + sizeof(szBuf), p);
+        return std::string(szBuf, pEnd - szBuf);
+    } else {
+        std::ostringstream stream;
+        stream << p;
+        return stream.str();
+    }
 }
 
 template <>
@@ -36,6 +81,167 @@ inline T Abs(const T& iValue) {
     return std::abs(iValue);
 }
 
+// StrCat/StrAppend 的一个参数转成的字符片段
+// 字符串直接引用, 数字用 to_chars 格式化到内部缓冲区, 其它类型退化为 ostream
+// 只作为临时对象使用, 不可拷贝
+class StrPiece {
+  public:
+    template <typename T>
+    StrPiece(const T& p) {
+        if constexpr (std::is_same<T, bool>::value) {
+            _strView = p ? "true" : "false";
+        } else if constexpr (std::is_same<T, char>::value) {
+            _szBuf[0] = p;
+            _strView = std::string_view(_szBuf, 1);
+        } else if constexpr (detail::IsCharConvNumber<T>::value) {
+            char* pEnd = detail::ToChars(_szBuf, _szBuf + sizeof(_szBuf), p);
+            _strView = std::string_view(_szBuf, pEnd - _szBuf);
+        } else if constexpr (std::is_pointer<T>::value && std::is_convertible<T, const char*>::value) {
+            _strView = p ? std::string_view(p) : std::string_view();
+        } else if constexpr (std::is_convertible<const T&, std::string_view>::value) {
+            _strView = std::string_view(p);
+        } else {
+            std::ostringstream stream;
+            stream << p;
+            _strOther = stream.str();
+            _strView = _strOther;
+        }
+    }
+
+    StrPiece(const StrPiece&) = delete;
+    StrPiece& operator=(const StrPiece&) = delete;
+
+    std::string_view View() const {
+        return _strView;
+    }
+
+  private:
+    char _szBuf[64];
+    std::string _strOther;
+    std::string_view _strView;
+};
+
+namespace detail {
+// 片段可以指向 str 自身, 此时需要扩容则先拼到临时串再交换, 避免扩容后读到已释放的内存
+template <size_t NCount>
+inline void AppendPieces(std::string& str, const StrPiece (&kPieces)[NCount]) {
+    size_t nTotal = str.size();
+    bool bAlias = false;
+    std::less_equal<const char*> kLessEqual;
+    const char* pBegin = str.data();
+    const char* pEnd = pBegin + str.size();
+    for (const auto& kPiece : kPieces) {
+        std::string_view sv = kPiece.View();
+        nTotal += sv.size();
+        if (!sv.empty() && kLessEqual(pBegin, sv.data()) && kLessEqual(sv.data(), pEnd)) {
+            bAlias = true;
+        }
+    }
+    if (bAlias && nTotal > str.capacity()) {
+        std::string strTemp;
+        strTemp.reserve(nTotal);
+        strTemp.append(str);
+        for (const auto& kPiece : kPieces) {
+            strTemp.append(kPiece.View().data(), kPiece.View().size());
+        }
+        str.swap(strTemp);
+        return;
+    }
+    str.reserve(nTotal);
+    for (const auto& kPiece : kPieces) {
+        str.append(kPiece.View().data(), kPiece.View().size());
+    }
+}
+} // namespace detail
+
+// 把所有参数追加到 str 末尾, 先算总长度只扩容一次
+// StrAppend(strKey, "user:", nUid, ":", strField);
+// 参数可以是 str 自身或其中的一段, 如 StrAppend(s, s, "x")
+template <typename... Args>
+inline std::string& StrAppend(std::string& str, const Args&... args) {
+    const StrPiece kPieces[] = {StrPiece(args)...};
+    detail::AppendPieces(str, kPieces);
+    return str;
+}
+
+inline std::string& StrAppend(std::string& str) {
+    return str;
+}
+
+// 拼接任意个参数, 数字格式与 ToString 一致
+template <typename... Args>
+inline std::string StrCat(const Args&... args) {
+    std::string str;
+    StrAppend(str, args...);
+    return str;
+}
+
+// 带内部缓冲区的字符串拼接, 不超过 N-1 字节时不分配内存, 超出后转到堆上
+// StrBuffer<> kBuf; kBuf.Append("user:", nUid); Log(kBuf.CStr());
+template <size_t N = 256>
+class StrBuffer {
+  public:
+    StrBuffer() {
+        _szBuf[0] = '\0';
+    }
+
+    template <typename... Args>
+    StrBuffer& Append(const Args&... args) {
+        const StrPiece kPieces[] = {StrPiece(args)...};
+        size_t nAdd = 0;
+        for (const auto& kPiece : kPieces) {
+            nAdd += kPiece.View().size();
+        }
+        if (!_bHeap && _nSize + nAdd < N) {
+            for (const auto& kPiece : kPieces) {
+                std::memcpy(_szBuf + _nSize, kPiece.View().data(), kPiece.View().size());
+                _nSize += kPiece.View().size();
+            }
+            _szBuf[_nSize] = '\0';
+            return *this;
+        }
+        if (!_bHeap) {
+            _strHeap.reserve(_nSize + nAdd);
+            _strHeap.assign(_szBuf, _nSize);
+            _bHeap = true;
+        }
+        // 参数可能指向自身的 View()
+        detail::AppendPieces(_strHeap, kPieces);
+        return *this;
+    }
+
+    std::string_view View() const {
+        return _bHeap ? std::string_view(_strHeap) : std::string_view(_szBuf, _nSize);
+    }
+
+    const char* CStr() const {
+        return _bHeap ? _strHeap.c_str() : _szBuf;
+    }
+
+    size_t Size() const {
+        return _bHeap ? _strHeap.size() : _nSize;
+    }
+
+    std::string Str() const {
+        return std::string(View());
+    }
+
+    // 清空内容, 已转到堆上的保留容量
+    void Clear() {
+        _nSize = 0;
+        _szBuf[0] = '\0';
+        _strHeap.clear();
+        _bHeap = false;
+    }
+
+  private:
+    char _szBuf[N];
+    size_t _nSize = 0;
+    bool _bHeap = false;
+    std::string _strHeap;
+};
+
+// 多参数 ToString 保持 ostream 的格式(bool 为 1/0, 浮点 6 位有效数字), 与 StrCat 不同
 template <typename T1, typename T2>
 inline std::string ToString(T1 p1, T2 p2) {
     std::ostringstream stream;
@@ -62,100 +268,151 @@ inline std::string ToString<bool>(bool _value) {
     return _value ? "true" : "false";
 }
 
-template <typename T>
-inline T ParseValue(const std::string& _value) {
-    std::istringstream stream(_value);
+// 解析数字, 允许前导空白和 '+', 末尾只允许空格和 tab; 无符号类型不接受负数
+// 成功返回 true; 失败时 value 不变, pErr 为 invalid_argument 或 result_out_of_range
+template <typename T, typename = typename std::enable_if<detail::IsCharConvNumber<T>::value>::type>
+inline bool TryParse(std::string_view _value, T& value, std::errc* pErr = nullptr) {
+    const char* p = _value.data();
+    const char* pEnd = p + _value.size();
+    while (p < pEnd && (*p == ' ' || (*p >= '\t' && *p <= '\r'))) {
+        p++;
+    }
+    if (p < pEnd && *p == '+' && pEnd - p > 1 && p[1] != '-') {
+        p++;
+    }
     T result;
-    stream >> result;
-    if (stream.fail()) {
-        return T();
+    std::errc eErr = std::errc();
+    if constexpr (std::is_floating_point<T>::value) {
+        // 与 istream 一致, 不接受 inf/nan
+        const char* pDigit = (p < pEnd && *p == '-') ? p + 1 : p;
+        if (pDigit == pEnd || !((*pDigit >= '0' && *pDigit <= '9') || *pDigit == '.')) {
+            eErr = std::errc::invalid_argument;
+        }
+    }
+    std::from_chars_result kRet = {p, eErr};
+    if (eErr == std::errc()) {
+        kRet = std::from_chars(p, pEnd, result);
+        eErr = kRet.ec;
+    }
+    if (eErr == std::errc()) {
+        for (p = kRet.ptr; p < pEnd; p++) {
+            if (*p != ' ' && *p != '\t') {
+                eErr = std::errc::invalid_argument;
+                break;
+            }
+        }
+    }
+    if (pErr) {
+        *pErr = eErr;
+    }
+    if (eErr != std::errc()) {
+        return false;
+    }
+    value = result;
+    return true;
+}
+
+// 解析失败返回 T(), 需要区分失败时用 TryParse
+template <typename T>
+inline T ParseValue(std::string_view _value) {
+    if constexpr (detail::IsCharConvNumber<T>::value) {
+        T result = T();
+        TryParse(_value, result);
+        return result;
     } else {
-        int item = stream.get();
-        while (item != -1) {
-            if (item != ' ' && item != '\t')
-                return T();
-            item = stream.get();
+        std::istringstream stream{std::string(_value)};
+        T result;
+        stream >> result;
+        if (stream.fail()) {
+            return T();
+        } else {
+            int item = stream.get();
+            while (item != -1) {
+                if (item != ' ' && item != '\t')
+                    return T();
+                item = stream.get();
+            }
         }
+        return result;
     }
-    return result;
 }
 
 template <>
-inline bool ParseValue(const std::string& _value) {
+inline bool ParseValue(std::string_view _value) {
     if (_value == "True" || _value == "true" || _value == "1")
         return true;
     return false;
 }
 
 template <>
-inline char ParseValue(const std::string& _value) {
+inline char ParseValue(std::string_view _value) {
     return (char)ParseValue<short>(_value);
 }
 
 template <>
-inline unsigned char ParseValue(const std::string& _value) {
+inline unsigned char ParseValue(std::string_view _value) {
     return (unsigned char)ParseValue<unsigned short>(_value);
 }
 
 template <>
-inline std::string ParseValue(const std::string& _value) {
-    return _value;
+inline std::string ParseValue(std::string_view _value) {
+    return std::string(_value);
 }
 
-inline long long ParseLLong(const std::string& _value) {
+inline long long ParseLLong(std::string_view _value) {
     return ParseValue<long long>(_value);
 }
 
-inline short ParseShort(const std::string& _value) {
+inline short ParseShort(std::string_view _value) {
     return ParseValue<short>(_value);
 }
 
-inline unsigned short ParseUShort(const std::string& _value) {
+inline unsigned short ParseUShort(std::string_view _value) {
     return ParseValue<unsigned short>(_value);
 }
 
-inline int ParseInt(const std::string& _value) {
+inline int ParseInt(std::string_view _value) {
     return ParseValue<int>(_value);
 }
 
-inline unsigned int ParseUInt(const std::string& _value) {
+inline unsigned int ParseUInt(std::string_view _value) {
     return ParseValue<unsigned int>(_value);
 }
 
-inline size_t ParseSizeT(const std::string& _value) {
+inline size_t ParseSizeT(std::string_view _value) {
     return ParseValue<size_t>(_value);
 }
 
-inline float ParseFloat(const std::string& _value) {
+inline float ParseFloat(std::string_view _value) {
     return ParseValue<float>(_value);
 }
 
-inline double ParseDouble(const std::string& _value) {
+inline double ParseDouble(std::string_view _value) {
     return ParseValue<double>(_value);
 }
 
-inline bool ParseBool(const std::string& _value) {
+inline bool ParseBool(std::string_view _value) {
     return ParseValue<bool>(_value);
 }
 
-inline char ParseChar(const std::string& _value) {
+inline char ParseChar(std::string_view _value) {
     return ParseValue<char>(_value);
 }
 
-inline unsigned char ParseUChar(const std::string& _value) {
+inline unsigned char ParseUChar(std::string_view _value) {
     return ParseValue<unsigned char>(_value);
 }
 
 namespace templates {
-template <typename T>
-inline void SplitImp(std::vector<std::string>& _ret, const std::string& _source, const std::string& _delims) {
+template <typename TVec>
+inline void SplitImp(TVec& _ret, const std::string& _source, const std::string& _delims) {
     size_t start = 0;
     size_t end = _source.find(_delims);
     while (start != _source.npos) {
         if (end != _source.npos)
-            _ret.push_back(_source.substr(start, end - start));
+            _ret.emplace_back(_source.data() + start, end - start);
         else {
-            _ret.push_back(_source.substr(start));
+            _ret.emplace_back(_source.data() + start, _source.size() - start);
             break;
         }
         start = end;
@@ -167,31 +424,509 @@ inline void SplitImp(std::vector<std::string>& _ret, const std::string& _source,
 }
 } //namespace templates
 
+// 注意: 按整个 _delims 序列切分, 而不是其中任一字符; 按字符集切分用 SplitView
 inline std::vector<std::string> Split(const std::string& _source, const std::string& _delims = "\t\n ") {
     std::vector<std::string> result;
-    templates::SplitImp<void>(result, _source, _delims);
+    templates::SplitImp(result, _source, _delims);
+    return result;
+}
+
+namespace detail {
+// 在 [p, pEnd) 中查找第一个属于字符集的字符, 字符集不超过 4 个时用 SIMD 扫描
+// kMask 为字符集的 256 位位图
+inline const char* FindAnyOf(const char* p, const char* pEnd, std::string_view strSet, const uint64_t* kMask) {
+    auto fnIn = [kMask](unsigned char c) {
+        return (kMask[c >> 6] >> (c & 63)) & 1;
+    };
+    if (p >= pEnd) {
+        return pEnd;
+    }
+    if (strSet.size() == 1) {
+        const void* pFind = std::memchr(p, strSet[0], pEnd - p);
+        return pFind ? static_cast<const char*>(pFind) : pEnd;
+    }
+#if defined(__AVX2__)
+    if (strSet.size() <= 4) {
+        __m256i kSet[4];
+        for (size_t i = 0; i < 4; i++) {
+            kSet[i] = _mm256_set1_epi8(strSet[i < strSet.size() ? i : 0]);
+        }
+        for (; pEnd - p >= 32; p += 32) {
+            __m256i kData = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            __m256i kHit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(kData, kSet[0]), _mm256_cmpeq_epi8(kData, kSet[1])),
+                                           _mm256_or_si256(_mm256_cmpeq_epi8(kData, kSet[2]), _mm256_cmpeq_epi8(kData, kSet[3])));
+            uint32_t nMask = (uint32_t)_mm256_movemask_epi8(kHit);
+            if (nMask) {
+                return p + __builtin_ctz(nMask);
+            }
+        }
+    }
+#endif
+#if defined(__SSE2__)
+    if (strSet.size() <= 4) {
+        __m128i kSet[4];
+        for (size_t i = 0; i < 4; i++) {
+            kSet[i] = _mm_set1_epi8(strSet[i < strSet.size() ? i : 0]);
+        }
+        for (; pEnd - p >= 16; p += 16) {
+            __m128i kData = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i kHit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(kData, kSet[0]), _mm_cmpeq_epi8(kData, kSet[1])),
+                                        _mm_or_si128(_mm_cmpeq_epi8(kData, kSet[2]), _mm_cmpeq_epi8(kData, kSet[3])));
+            uint32_t nMask = (uint32_t)_mm_movemask_epi8(kHit);
+            if (nMask) {
+                return p + __builtin_ctz(nMask);
+            }
+        }
+    }
+#endif
+    for (; p < pEnd; p++) {
+        if (fnIn((unsigned char)*p)) {
+            return p;
+        }
+    }
+    return pEnd;
+}
+
+// 在 [p, pEnd) 中查找子串, 先用 SIMD 同时比较首尾字符筛选候选位置再逐个确认
+inline const char* FindSeq(const char* p, const char* pEnd, std::string_view strDelim) {
+    size_t n = strDelim.size();
+    if (p >= pEnd || (size_t)(pEnd - p) < n) {
+        return pEnd;
+    }
+    if (n == 1) {
+        const void* pFind = std::memchr(p, strDelim[0], pEnd - p);
+        return pFind ? static_cast<const char*>(pFind) : pEnd;
+    }
+    // 候选起点的上界(不含)
+    const char* pLast = pEnd - n + 1;
+#if defined(__AVX2__)
+    {
+        __m256i kFirst = _mm256_set1_epi8(strDelim[0]);
+        __m256i kBack = _mm256_set1_epi8(strDelim[n - 1]);
+        for (; pLast - p >= 32; p += 32) {
+            __m256i kA = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            __m256i kB = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + n - 1));
+            uint32_t nMask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(kA, kFirst), _mm256_cmpeq_epi8(kB, kBack)));
+            while (nMask) {
+                int nBit = __builtin_ctz(nMask);
+                if (std::memcmp(p + nBit + 1, strDelim.data() + 1, n - 2) == 0) {
+                    return p + nBit;
+                }
+                nMask &= nMask - 1;
+            }
+        }
+    }
+#endif
+#if defined(__SSE2__)
+    {
+        __m128i kFirst = _mm_set1_epi8(strDelim[0]);
+        __m128i kBack = _mm_set1_epi8(strDelim[n - 1]);
+        for (; pLast - p >= 16; p += 16) {
+            __m128i kA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i kB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + n - 1));
+            uint32_t nMask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(kA, kFirst), _mm_cmpeq_epi8(kB, kBack)));
+            while (nMask) {
+                int nBit = __builtin_ctz(nMask);
+                if (std::memcmp(p + nBit + 1, strDelim.data() + 1, n - 2) == 0) {
+                    return p + nBit;
+                }
+                nMask &= nMask - 1;
+            }
+        }
+    }
+#endif
+    std::string_view strRest(p, pEnd - p);
+    size_t nPos = strRest.find(strDelim);
+    return nPos == std::string_view::npos ? pEnd : p + nPos;
+}
+} // namespace detail
+
+// 惰性切分, 逐个产生 string_view, 不分配内存; 结果引用原字符串, 原字符串需比它活得久
+// 与 Split 一样保留空字段, 空串产生一个空字段
+// for (std::string_view strField : SplitView(strLine, "\t")) {...}
+// SplitView(strLine, "\r\n", SplitView::eSequence) 按整个分隔串切分
+class SplitView {
+  public:
+    enum Mode {
+        eAnyOf = 0,    // 遇到分隔符集合中任一字符就切分
+        eSequence = 1, // 遇到完整的分隔串才切分
+    };
+
+    SplitView(std::string_view strSource, std::string_view strDelims = "\t\n ", Mode eMode = eAnyOf)
+        : _strSource(strSource), _strDelims(strDelims), _eMode(eMode) {
+        if (_eMode == eAnyOf) {
+            for (unsigned char c : _strDelims) {
+                _kMask[c >> 6] |= 1ull << (c & 63);
+            }
+        }
+    }
+
+    class iterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        iterator() {}
+
+        reference operator*() const {
+            return _strField;
+        }
+
+        pointer operator->() const {
+            return &_strField;
+        }
+
+        iterator& operator++() {
+            if (_pFieldEnd == _pView->End()) {
+                _pView = nullptr;
+                return *this;
+            }
+            Seek(_pFieldEnd + _pView->DelimSize());
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator kOld = *this;
+            ++*this;
+            return kOld;
+        }
+
+        bool operator==(const iterator& other) const {
+            return _pView == other._pView && (!_pView || _strField.data() == other._strField.data());
+        }
+
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+
+      private:
+        friend class SplitView;
+
+        explicit iterator(const SplitView* pView)
+            : _pView(pView) {
+            Seek(pView->_strSource.data());
+        }
+
+        void Seek(const char* pStart) {
+            _pFieldEnd = _pView->FindDelim(pStart);
+            _strField = std::string_view(pStart, _pFieldEnd - pStart);
+        }
+
+        const SplitView* _pView = nullptr;
+        const char* _pFieldEnd = nullptr;
+        std::string_view _strField;
+    };
+
+    iterator begin() const {
+        return iterator(this);
+    }
+
+    iterator end() const {
+        return iterator();
+    }
+
+    // 依次取出字段, 没有更多字段时返回 false
+    // SplitView kSplit(strLine, ","); std::string_view strField; while (kSplit.Next(strField)) {...}
+    bool Next(std::string_view& strField) {
+        if (_bDone) {
+            return false;
+        }
+        const char* pStart = _pNext ? _pNext : _strSource.data();
+        const char* pFieldEnd = FindDelim(pStart);
+        strField = std::string_view(pStart, pFieldEnd - pStart);
+        if (pFieldEnd == End()) {
+            _bDone = true;
+        } else {
+            _pNext = pFieldEnd + DelimSize();
+        }
+        return true;
+    }
+
+    // 全部字段追加到 vec
+    template <typename TVec>
+    void ToVector(TVec& vec) const {
+        for (std::string_view strField : *this) {
+            vec.emplace_back(strField);
+        }
+    }
+
+  private:
+    const char* End() const {
+        return _strSource.data() + _strSource.size();
+    }
+
+    size_t DelimSize() const {
+        return _eMode == eAnyOf ? 1 : _strDelims.size();
+    }
+
+    const char* FindDelim(const char* p) const {
+        if (_strDelims.empty()) {
+            return End();
+        }
+        if (_eMode == eAnyOf) {
+            return detail::FindAnyOf(p, End(), _strDelims, _kMask);
+        }
+        return detail::FindSeq(p, End(), _strDelims);
+    }
+
+    std::string_view _strSource;
+    std::string_view _strDelims;
+    Mode _eMode;
+    uint64_t _kMask[4] = {0, 0, 0, 0};
+    const char* _pNext = nullptr;
+    bool _bDone = false;
+};
+
+#if __has_include(<memory_resource>)
+// 从 memory_resource(如 ArenaResource) 分配结果的版本, 请求结束时随 Arena 一起释放
+namespace pmr {
+inline std::pmr::vector<std::pmr::string> Split(const std::string& _source, const std::string& _delims = "\t\n ",
+                                                std::pmr::memory_resource* pRes = std::pmr::get_default_resource()) {
+    std::pmr::vector<std::pmr::string> result(pRes);
+    templates::SplitImp(result, _source, _delims);
     return result;
 }
 
-inline std::string& ReplaceAll(std::string& str, const std::string& tar, const std::string& sou) {
-    if (str.empty() || str.size() < tar.size()) {
+template <typename T>
+inline std::pmr::string ToString(const T& p, std::pmr::memory_resource* pRes = std::pmr::get_default_resource()) {
+    if constexpr (std::is_same<T, bool>::value) {
+        return std::pmr::string(p ? "true" : "false", pRes);
+    } else if constexpr (std::is_same<T, char>::value) {
+        return std::pmr::string(1, p, pRes);
+    } else if constexpr (detail::IsCharConvNumber<T>::value) {
+        char szBuf[64];
+        char* pEnd = detail::ToChars(szBuf, szBuf + sizeof(szBuf), p);
+        return std::pmr::string(szBuf, pEnd - szBuf, pRes);
+    } else if constexpr (std::is_convertible<const T&, std::string_view>::value) {
+        return std::pmr::string(std::string_view(p), pRes);
+    } else {
+        std::ostringstream stream;
+        stream << p;
+        return std::pmr::string(stream.str(), pRes);
+    }
+}
+} // namespace pmr
+#endif
+
+// 从左到右替换所有不重叠的 tar, 替换进来的内容不会再被匹配
+// 替换串不长于目标串时原地完成, 否则一次分配生成结果
+inline std::string& ReplaceAll(std::string& str, std::string_view tar, std::string_view sou) {
+    if (tar.empty() || str.size() < tar.size()) {
         return str;
     }
-    auto pos = str.find(tar, 0);
-    while (pos != std::string::npos) {
-        str.replace(pos, tar.size(), sou);
-        pos = str.find(tar, pos);
+    const char* pBegin = str.data();
+    const char* pEnd = pBegin + str.size();
+    const char* pFind = detail::FindSeq(pBegin, pEnd, tar);
+    if (pFind == pEnd) {
+        return str;
+    }
+
+    if (sou.size() <= tar.size()) {
+        // 写位置始终不超过读位置
+        char* pWrite = &str[0] + (pFind - pBegin);
+        const char* pRead = pFind;
+        while (pFind != pEnd) {
+            if (pFind != pRead) {
+                std::memmove(pWrite, pRead, pFind - pRead);
+                pWrite += pFind - pRead;
+            }
+            std::memcpy(pWrite, sou.data(), sou.size());
+            pWrite += sou.size();
+            pRead = pFind + tar.size();
+            pFind = detail::FindSeq(pRead, pEnd, tar);
+        }
+        std::memmove(pWrite, pRead, pEnd - pRead);
+        pWrite += pEnd - pRead;
+        str.resize(pWrite - str.data());
+        return str;
     }
+
+    size_t nCount = 0;
+    for (const char* p = pFind; p != pEnd; p = detail::FindSeq(p + tar.size(), pEnd, tar)) {
+        ++nCount;
+    }
+    std::string strOut;
+    strOut.reserve(str.size() + nCount * (sou.size() - tar.size()));
+    const char* pRead = pBegin;
+    while (pFind != pEnd) {
+        strOut.append(pRead, pFind - pRead);
+        strOut.append(sou.data(), sou.size());
+        pRead = pFind + tar.size();
+        pFind = detail::FindSeq(pRead, pEnd, tar);
+    }
+    strOut.append(pRead, pEnd - pRead);
+    str.swap(strOut);
     return str;
 }
 
+// 多模式替换, 一次扫描替换所有模式; 同一位置有多个模式匹配时取最长的, 从左到右不重叠
+// 模式存成按字节跳转的 trie, 只有模式首字节出现的位置才会进入 trie 匹配
+// MultiReplacer kReplacer({{"<", "&lt;"}, {">", "&gt;"}, {"&", "&amp;"}});
+// std::string strSafe = kReplacer.Replace(strInput);
+class MultiReplacer {
+  public:
+    MultiReplacer() {
+        Build();
+    }
+
+    MultiReplacer(std::initializer_list<std::pair<std::string_view, std::string_view>> kPatterns) {
+        for (auto& kPattern : kPatterns) {
+            _vecPattern.emplace_back(std::string(kPattern.first), std::string(kPattern.second));
+        }
+        Build();
+    }
+
+    // 增加一个模式, 空模式忽略; 同一个模式后加的覆盖先加的
+    void Add(std::string_view strFrom, std::string_view strTo) {
+        _vecPattern.emplace_back(std::string(strFrom), std::string(strTo));
+        Build();
+    }
+
+    std::string Replace(std::string_view strSource) const {
+        std::string strOut;
+        ReplaceTo(strSource, strOut);
+        return strOut;
+    }
+
+    // 结果追加到 strOut
+    void ReplaceTo(std::string_view strSource, std::string& strOut) const {
+        strOut.reserve(strOut.size() + strSource.size());
+        const unsigned char* pData = reinterpret_cast<const unsigned char*>(strSource.data());
+        size_t nSize = strSource.size();
+        size_t nCopyFrom = 0;
+        size_t i = 0;
+        while (i < nSize) {
+            if (!_bFirst[pData[i]]) {
+                ++i;
+                continue;
+            }
+            int32_t nMatch = -1;
+            size_t nMatchLen = 0;
+            int32_t nState = 0;
+            for (size_t j = i; j < nSize; j++) {
+                uint16_t nClass = _kClass[pData[j]];
+                if (nClass == 0) {
+                    break;
+                }
+                nState = _vecNext[nState * _nClasses + nClass];
+                if (nState <= 0) {
+                    break;
+                }
+                if (_vecOut[nState] >= 0) {
+                    nMatch = _vecOut[nState];
+                    nMatchLen = j - i + 1;
+                }
+            }
+            if (nMatch < 0) {
+                ++i;
+                continue;
+            }
+            strOut.append(strSource.data() + nCopyFrom, i - nCopyFrom);
+            strOut.append(_vecPattern[nMatch].second);
+            i += nMatchLen;
+            nCopyFrom = i;
+        }
+        strOut.append(strSource.data() + nCopyFrom, nSize - nCopyFrom);
+    }
+
+  private:
+    void Build() {
+        std::memset(_kClass, 0, sizeof(_kClass));
+        std::memset(_bFirst, 0, sizeof(_bFirst));
+        // 只给模式中出现过的字节分配列, 压缩跳转表
+        _nClasses = 1;
+        for (auto& kPattern : _vecPattern) {
+            for (unsigned char c : kPattern.first) {
+                if (_kClass[c] == 0) {
+                    _kClass[c] = (uint16_t)_nClasses++;
+                }
+            }
+        }
+        _vecNext.assign(_nClasses, 0);
+        _vecOut.assign(1, -1);
+        for (size_t nIndex = 0; nIndex < _vecPattern.size(); nIndex++) {
+            const std::string& strFrom = _vecPattern[nIndex].first;
+            if (strFrom.empty()) {
+                continue;
+            }
+            _bFirst[(unsigned char)strFrom[0]] = true;
+            int32_t nState = 0;
+            for (unsigned char c : strFrom) {
+                int32_t& nNext = _vecNext[nState * _nClasses + _kClass[c]];
+                if (nNext == 0) {
+                    nNext = (int32_t)_vecOut.size();
+                    _vecOut.push_back(-1);
+                    _vecNext.resize(_vecNext.size() + _nClasses, 0);
+                }
+                // resize 可能使 nNext 引用失效, 重新读取
+                nState = _vecNext[nState * _nClasses + _kClass[c]];
+            }
+            _vecOut[nState] = (int32_t)nIndex;
+        }
+    }
+
+    std::vector<std::pair<std::string, std::string>> _vecPattern;
+    // 字节到列的映射, 0 表示不出现在任何模式中
+    uint16_t _kClass[256];
+    bool _bFirst[256];
+    int32_t _nClasses = 1;
+    // 状态 * _nClasses + 列 -> 下一个状态, 0 表示没有
+    std::vector<int32_t> _vecNext;
+    // 状态结束的模式下标, -1 表示不是模式结尾
+    std::vector<int32_t> _vecOut;
+};
+
+namespace detail {
+// 只转换 'a'-'z' 或 'A'-'Z', 其它字节(包括 UTF-8 多字节字符)保持不变
+// cFrom 为需要转换范围的首字符, nDelta 为加上的差值
+inline void AsciiCaseConvert(char* p, size_t nSize, char cFrom, char nDelta) {
+    char* pEnd = p + nSize;
+#if defined(__AVX2__)
+    {
+        // 加上偏移后目标范围正好落在 [-128, -128 + 26), 一次有符号比较即可
+        const __m256i kShift = _mm256_set1_epi8((char)(128 - cFrom));
+        const __m256i kLimit = _mm256_set1_epi8((char)(-128 + 26));
+        const __m256i kDelta = _mm256_set1_epi8(nDelta);
+        for (; pEnd - p >= 32; p += 32) {
+            __m256i kData = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            __m256i kIn = _mm256_cmpgt_epi8(kLimit, _mm256_add_epi8(kData, kShift));
+            kData = _mm256_add_epi8(kData, _mm256_and_si256(kIn, kDelta));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), kData);
+        }
+    }
+#endif
+#if defined(__SSE2__)
+    {
+        const __m128i kShift = _mm_set1_epi8((char)(128 - cFrom));
+        const __m128i kLimit = _mm_set1_epi8((char)(-128 + 26));
+        const __m128i kDelta = _mm_set1_epi8(nDelta);
+        for (; pEnd - p >= 16; p += 16) {
+            __m128i kData = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i kIn = _mm_cmplt_epi8(_mm_add_epi8(kData, kShift), kLimit);
+            kData = _mm_add_epi8(kData, _mm_and_si128(kIn, kDelta));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(p), kData);
+        }
+    }
+#endif
+    for (; p < pEnd; p++) {
+        if ((unsigned char)(*p - cFrom) < 26) {
+            *p = (char)(*p + nDelta);
+        }
+    }
+}
+} // namespace detail
+
+// 只转换 ASCII 字母, 不受 locale 影响
 inline std::string& ToUpper(std::string& str) {
-    std::transform(str.begin(), str.end(), str.begin(), ::toupper);
+    detail::AsciiCaseConvert(&str[0], str.size(), 'a', 'A' - 'a');
     return str;
 }
 
 inline std::string& ToLower(std::string& str) {
-    std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+    detail::AsciiCaseConvert(&str[0], str.size(), 'A', 'a' - 'A');
     return str;
 }
 } // namespace strutils
@@ -5,43 +5,64 @@
 
 #include "Queue.hpp"
 #include "Signal.hpp"
+#include "Future.hpp"
+#include "InplaceTask.hpp"
+#include "Coroutine.hpp"
 
 namespace xs {
 
-class TaskPool {
-  public:
-    struct TaskWrap {
-        enum Tasktype : char {
-            eTaskStop = 0,
-            eTask = 1,
-        };
-        Tasktype eType = eTask;
-        std::function<void()> func = nullptr;
+struct TaskWrap {
+    enum Tasktype : char {
+        eTaskStop = 0,
+        eTask = 1,
     };
+    Tasktype eType = eTask;
+    InplaceTask func = nullptr;
+};
 
-    TaskPool(int cnt = 1) {
+// TQueue 为任务队列类型, 需提供 Push/WaitPop, 如 Queue<TaskWrap> 或 RingQueue<TaskWrap, N>
+template <typename TQueue = Queue<TaskWrap>>
+class TaskPoolT {
+  public:
+    using TaskWrap = ::xs::TaskWrap;
+
+    TaskPoolT(int cnt = 1) {
         m_bRun = true;
         for (int i = 0; i < cnt; i++) {
-            auto pThread = std::make_unique<std::thread>(std::bind(&TaskPool::OnWork, this));
+            auto pThread = std::make_unique<std::thread>(std::bind(&TaskPoolT::OnWork, this));
             m_Threads.emplace_back(std::move(pThread));
         }
     }
 
-    virtual ~TaskPool() {
+    virtual ~TaskPoolT() {
         Stop();
     }
 
-    bool PushTask(std::function<void()> func) {
+    bool PushTask(InplaceTask func) {
         TaskWrap kItem;
         kItem.func = std::move(func);
-        bool bPush = m_queTask.Push(kItem);
+        bool bPush = m_queTask.Push(std::move(kItem));
         return bPush;
     }
 
+    // 投递 fn(args...), 返回其结果的 Future
+    template <typename F, typename... Args>
+    auto Submit(F&& fn, Args&&... args) {
+        return SubmitTo(*this, std::forward<F>(fn), std::forward<Args>(args)...);
+    }
+
+#ifdef XS_HAS_COROUTINE
+    // co_await pool.Schedule() 切换到工作线程继续执行
+    auto Schedule() {
+        return ScheduleOn(*this);
+    }
+#endif
+
   protected:
     void OnWork() {
         TaskWrap kItem;
-        while (m_bRun) {
+        // 停止标记排在已提交的任务之后, 收到标记前先执行完已提交的任务
+        while (true) {
             if (!m_queTask.WaitPop(kItem)) {
                 continue;
             }
@@ -60,7 +81,10 @@ class TaskPool {
         for (int i = 0; i <= m_Threads.size(); i++) {
             TaskWrap kItem;
             kItem.eType = TaskWrap::eTaskStop;
-            m_queTask.Push(kItem);
+            // 有界队列满时等待消费
+            while (!m_queTask.Push(std::move(kItem))) {
+                std::this_thread::yield();
+            }
         }
 
         for (auto& pThread : m_Threads) {
@@ -70,8 +94,10 @@ class TaskPool {
         }
     }
 
-    Queue<TaskWrap> m_queTask;
+    TQueue m_queTask;
     std::atomic<bool> m_bRun;
     std::vector<std::unique_ptr<std::thread>> m_Threads;
 };
+
+using TaskPool = TaskPoolT<>;
 } // namespace xs
\ No newline at end of file
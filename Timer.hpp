@@ -1,17 +1,32 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <thread>
+#include <type_traits>
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+#include "InplaceTask.hpp"
+#include "Coroutine.hpp"
+#include "TimingWheel.hpp"
+#include "Future.hpp"
+#include "Signal.hpp"
 
 namespace xs {
 
 class Timer {
   public:
-    typedef std::chrono::seconds TimeDuration;
-    typedef std::chrono::system_clock::time_point TimePoint;
+    // 任务时间使用单调时钟, 不受系统时间调整影响
+    typedef std::chrono::microseconds TimeDuration;
+    typedef std::chrono::steady_clock::time_point TimePoint;
+    typedef std::chrono::microseconds MicroSeconds;
     typedef std::chrono::milliseconds MilliSeconds;
     typedef std::chrono::seconds Seconds;
     typedef std::chrono::minutes Minutes;
@@ -20,6 +35,23 @@ class Timer {
     typedef std::mutex Lock;
     typedef std::lock_guard<std::mutex> AutoLock;
 
+    // 任务调度引擎
+    enum Engine : char {
+        eHeap = 0,  // 小根堆, 插入 O(log n), 取消的任务到期才移除
+        eWheel = 1, // 分层时间轮, 精度 1ms, 插入/取消 O(1)
+    };
+
+    Timer(Engine eEngine = eHeap)
+        : _eEngine(eEngine), _ePendingEngine(eEngine), _nEpoch(NowTime()) {
+    }
+
+    ~Timer() {
+        Stop();
+        _wheel.Clear([](TimingWheelNode* pNode) {
+            static_cast<TimeTask*>(pNode)->pWheelHold.reset();
+        });
+    }
+
     static Timer& Instace() {
         // it's safe in c++11 and later:
         // https://en.cppreference.com/w/cpp/language/storage_duration#Static_local_variables
@@ -62,11 +94,37 @@ class Timer {
         std::time_t now_t = time(nullptr);
         return GMTime(now_t);
     }
-    // 当前时间
+    // 当前时间, 单调时钟
     static TimePoint NowTime() {
+        return std::chrono::steady_clock::now();
+    }
+
+    // 粗粒度单调时钟, 读取开销更小, 精度为内核 tick (1-4ms), 不会超前于 NowTime
+    static TimePoint CoarseNowTime() {
+#if defined(CLOCK_MONOTONIC_COARSE)
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        return TimePoint(std::chrono::duration_cast<TimePoint::duration>(std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec)));
+#else
+        return NowTime();
+#endif
+    }
+
+    // 当前系统时间
+    static std::chrono::system_clock::time_point WallTime() {
         return std::chrono::system_clock::now();
     }
 
+    // 最近一次 OnTime 读取的时间, 供回调中使用, 避免重复读时钟
+    const TimePoint& CachedNowTime() const {
+        return _nNow;
+    }
+
+    // 开启后 OnTime 使用 CoarseNowTime, 任务最多延后一个内核 tick
+    void SetCoarseClock(bool bCoarse) {
+        _bCoarseClock.store(bCoarse, std::memory_order_relaxed);
+    }
+
     // 任务基类
     struct Task {
         // 取消任务执行
@@ -75,20 +133,33 @@ class Timer {
     };
 
     struct TimeTask;
+    struct EveryBase;
     // 任务类指针
     using TimeTaskPtr = std::shared_ptr<TimeTask>;
 
     // 任务类
-    struct TimeTask : public Task {
+    struct TimeTask : public Task, public TimingWheelNode, public std::enable_shared_from_this<TimeTask> {
         int32_t nRepeat = 1;
-        Seconds nDelayTime = Seconds(0);
-        Seconds nInterval = Seconds(1);
-        std::function<void()> fnCallback = nullptr;
+        TimeDuration nDelayTime = TimeDuration(0);
+        TimeDuration nInterval = Seconds(1);
+        // 按日历循环的任务, 每次按系统时间重新计算下次调用时间
+        std::shared_ptr<EveryBase> pEvery;
+        bool bEveryStarted = false;
+        InplaceTask fnCallback = nullptr;
         TimePoint nNextCallTime;
         std::atomic_bool bCancel = {false};
+        // 所属的定时器
+        Timer* pOwner = nullptr;
+        // 挂在时间轮上时持有自身
+        TimeTaskPtr pWheelHold;
         // 取消任务执行
         virtual bool Cancel() override {
-            bCancel.store(true);
+            if (bCancel.exchange(true)) {
+                return true;
+            }
+            if (pOwner) {
+                pOwner->OnCancel(shared_from_this());
+            }
             return true;
         }
         virtual const TimePoint& NextCallTimePoint() {
@@ -120,7 +191,15 @@ class Timer {
             if (nRepeat == 0) {
                 return false;
             }
-            if (nDelayTime.count() != 0) {
+            if (pEvery) {
+                TimeDuration nDelay = pEvery->GetNextCallDelay();
+                // 单调时钟与系统时间有偏差, 刚调用过时可能还没走到整秒, 避免同一时刻重复调用
+                if (bEveryStarted && nDelay < pEvery->GetInterval() / 2) {
+                    nDelay += pEvery->GetInterval();
+                }
+                bEveryStarted = true;
+                nNextCallTime = nNow + nDelay;
+            } else if (nDelayTime.count() != 0) {
                 nNextCallTime = nNow + nDelayTime;
                 nDelayTime = TimeDuration(0);
             } else {
@@ -223,45 +302,177 @@ class Timer {
     // 延迟调用 1 次
     // @param nDelaySec 延迟多少秒
     // @param func 调用函数
-    static std::shared_ptr<Task> After(uint32_t nDelaySec, const std::function<void()>& func) {
-        auto pTask = Instace().NewTask();
-        pTask->fnCallback = func;
+    static std::shared_ptr<Task> After(uint32_t nDelaySec, InplaceTask func) {
+        auto pTask = std::make_shared<TimeTask>();
+        pTask->fnCallback = std::move(func);
         pTask->nDelayTime = Seconds(nDelaySec);
         pTask->nInterval = Seconds(0);
         pTask->nRepeat = 1;
         pTask->UpdataNextCallTime(NowTime());
+        Instace().AddTask(pTask);
         return pTask;
     }
 
+    // 延迟调用 1 次
+    // @param nDelay 延迟时间, 精度到微秒, 如 MilliSeconds(50)
+    // @param func 调用函数
+    static std::shared_ptr<Task> After(TimeDuration nDelay, InplaceTask func) {
+        return Schedule(std::move(func), nDelay, 1);
+    }
+
     // 调度调用 n 次
     // @param func 调用函数
     // @param nInterval 调用间隔
     // @param nRepeat 调用次数, -1 为无限次
-    // @param nDelayTime 延迟多少秒调用
-    static std::shared_ptr<Task> Schedule(const std::function<void()>& func, Seconds nInterval, int32_t nRepeat = -1, Seconds nDelayTime = Seconds(0)) {
+    // @param nDelayTime 延迟多久调用
+    // 间隔与延迟精度到微秒, 如 MilliSeconds(20)
+    static std::shared_ptr<Task> Schedule(InplaceTask func, TimeDuration nInterval, int32_t nRepeat = -1, TimeDuration nDelayTime = TimeDuration(0)) {
         if (!func || nInterval.count() < 0 || nRepeat == 0 || nDelayTime.count() < 0) {
             return nullptr;
         }
-        auto pTask = Instace().NewTask();
-        pTask->fnCallback = func;
+        auto pTask = std::make_shared<TimeTask>();
+        pTask->fnCallback = std::move(func);
         pTask->nInterval = nInterval;
         pTask->nRepeat = nRepeat;
         pTask->nDelayTime = nDelayTime;
         pTask->UpdataNextCallTime(NowTime());
+        Instace().AddTask(pTask);
         return pTask;
     }
 
+    // 按日历循环调用, 如 Schedule(func, EveryDay(4, 30))
+    // @param func 调用函数
+    // @param kEvery EveryHour/EveryDay/EveryWeek
+    // @param nRepeat 调用次数, -1 为无限次
+    template <typename TEvery, typename = typename std::enable_if<std::is_base_of<EveryBase, TEvery>::value>::type>
+    static std::shared_ptr<Task> Schedule(InplaceTask func, const TEvery& kEvery, int32_t nRepeat = -1) {
+        if (!func || nRepeat == 0) {
+            return nullptr;
+        }
+        auto pTask = std::make_shared<TimeTask>();
+        pTask->fnCallback = std::move(func);
+        pTask->pEvery = std::make_shared<TEvery>(kEvery);
+        pTask->nRepeat = nRepeat;
+        pTask->UpdataNextCallTime(NowTime());
+        Instace().AddTask(pTask);
+        return pTask;
+    }
+
+#ifdef XS_HAS_COROUTINE
+    // co_await Timer::Sleep(ms), 由 OnTime 所在线程恢复协程
+    static auto Sleep(MilliSeconds nDelay) {
+        struct SleepAwaiter {
+            MilliSeconds nDelay;
+
+            bool await_ready() const noexcept {
+                return nDelay.count() <= 0;
+            }
+
+            void await_suspend(std::coroutine_handle<> h) {
+                Schedule([h]() { h.resume(); }, nDelay, 1);
+            }
+
+            void await_resume() noexcept {
+            }
+        };
+        return SleepAwaiter{nDelay};
+    }
+#endif
+
     // 添加任务
     // @param pTask 任务
     void AddTask(TimeTaskPtr pTask) {
         AutoLock k(_lock);
+        if (pTask->pOwner != this) {
+            pTask->pOwner = this;
+        }
+        // 驱动线程睡眠期间加入了更早的任务, 提前唤醒
+        if (_pThread && pTask->nNextCallTime < _nWakeTime) {
+            _nWakeTime = pTask->nNextCallTime;
+            _signal.Notify();
+        }
         _cache.emplace(pTask);
     }
 
+    // 设置回调执行器, 到期的回调投递到 pool 中执行, 不阻塞其它定时任务
+    // 同一个重复任务的回调比间隔慢时, 可能在不同线程上同时执行
+    // 需在 Start 之前设置
+    template <typename TPool>
+    void SetExecutor(TPool& pool) {
+        _kExecutor = Executor::Of(pool);
+    }
+
+    void SetExecutor(const Executor& kExecutor) {
+        _kExecutor = kExecutor;
+    }
+
+    // 启动驱动线程, 之后不要再手动调用 OnTime
+    // 线程睡眠到最近的任务到期, 有更早的任务加入时提前唤醒
+    bool Start() {
+        AutoLock k(_lock);
+        if (_pThread) {
+            return false;
+        }
+        _bRunning = true;
+        _pThread = std::make_unique<std::thread>(&Timer::OnDrive, this);
+        return true;
+    }
+
+    void Stop() {
+        std::unique_ptr<std::thread> pThread;
+        {
+            AutoLock k(_lock);
+            if (!_pThread) {
+                return;
+            }
+            _bRunning = false;
+            pThread = std::move(_pThread);
+        }
+        _signal.Notify();
+        if (pThread->joinable()) {
+            pThread->join();
+        }
+    }
+
+    // 最近一个任务的到期时间, 没有任务时返回 TimePoint::max()
+    // 只用于不 Start、自行调用 OnTime 的场景, 需在调用 OnTime 的线程上调用; Start 之后仅供驱动线程使用
+    TimePoint NextCallTime() {
+        if (_eEngine == eWheel) {
+            uint64_t nTick = _wheel.NextExpireTick();
+            if (nTick == TimingWheel::kNever) {
+                return TimePoint::max();
+            }
+            return _nEpoch + MilliSeconds(nTick);
+        }
+        if (_queue.empty()) {
+            return TimePoint::max();
+        }
+        return _queue.top()->nNextCallTime;
+    }
+
+    // 切换调度引擎, 已有任务一并迁移; 任意线程可调用, 在下一次 OnTime 时生效
+    void SetEngine(Engine eEngine) {
+        AutoLock k(_lock);
+        _ePendingEngine = eEngine;
+        if (_pThread && eEngine != _eEngine) {
+            _signal.Notify();
+        }
+    }
+
     // 时间触发回调
     void OnTime() {
         TransferTask();
-        TimePoint nNow = NowTime();
+        // 每次只读一次时钟
+        _nNow = _bCoarseClock.load(std::memory_order_relaxed) ? CoarseNowTime() : NowTime();
+        const TimePoint& nNow = _nNow;
+
+        if (_eEngine == eWheel) {
+            _wheel.Advance(ToTick(nNow), [&](TimingWheelNode* pNode) {
+                auto pTask = std::move(static_cast<TimeTask*>(pNode)->pWheelHold);
+                RunTask(pTask, nNow);
+            });
+            return;
+        }
 
         do {
             if (_queue.empty()) {
@@ -273,23 +484,138 @@ class Timer {
             }
             _queue.pop();
 
-            pTop->Call();
+            RunTask(pTop, nNow);
+        } while (true);
+    }
 
-            if (pTop->UpdataNextCallTime(nNow)) {
-                AddTask(pTop);
-            } else {
-                pTop->Clear();
+    // 执行到期任务, 需要重复的重新加入
+    void RunTask(const TimeTaskPtr& pTask, const TimePoint& nNow) {
+        if (_kExecutor) {
+            if (pTask->bCancel) {
+                return;
             }
-        } while (true);
+            bool bRepeat = pTask->UpdataNextCallTime(nNow);
+            bool bPosted = _kExecutor.Post([pTask, bRepeat]() {
+                pTask->Call();
+                if (!bRepeat) {
+                    pTask->Clear();
+                }
+            });
+            if (!bPosted) {
+                // 执行器已停止, 在定时器线程上执行
+                pTask->Call();
+                if (!bRepeat) {
+                    pTask->Clear();
+                }
+            }
+            if (bRepeat) {
+                AddTask(pTask);
+            }
+            return;
+        }
+
+        pTask->Call();
+
+        if (pTask->UpdataNextCallTime(nNow)) {
+            AddTask(pTask);
+        } else {
+            pTask->Clear();
+        }
+    }
+
+    // 驱动线程
+    void OnDrive() {
+        while (_bRunning) {
+            OnTime();
+
+            TimePoint nNext = NextCallTime();
+            {
+                AutoLock k(_lock);
+                if (!_cache.empty()) {
+                    continue;
+                }
+                _nWakeTime = nNext;
+            }
+            TimePoint nNow = _bCoarseClock.load(std::memory_order_relaxed) ? CoarseNowTime() : NowTime();
+            if (nNext > nNow) {
+                // 最多睡眠 kMaxDriveWait, 防止长时间睡眠
+                auto nWait = nNext - nNow;
+                _signal.WaitFor(nWait < kMaxDriveWait ? std::chrono::duration_cast<TimeDuration>(nWait) + TimeDuration(1) : kMaxDriveWait);
+            }
+        }
     }
 
     // 任务转移
     void TransferTask() {
         AutoLock k(_lock);
+        if (_ePendingEngine != _eEngine) {
+            SwitchEngine();
+        }
         while (!_cache.empty()) {
-            _queue.push(_cache.front());
+            auto pTask = std::move(_cache.front());
             _cache.pop();
+            if (_eEngine == eWheel) {
+                if (pTask->bCancel) {
+                    ClearTask(pTask);
+                    continue;
+                }
+                pTask->nExpireTick = ToTick(pTask->nNextCallTime, true);
+                pTask->pWheelHold = pTask;
+                _wheel.Add(pTask.get());
+            } else {
+                _queue.push(pTask);
+            }
+        }
+        while (!_cancel.empty()) {
+            auto pTask = std::move(_cancel.front());
+            _cancel.pop();
+            if (pTask->IsLinked()) {
+                _wheel.Remove(pTask.get());
+                pTask->pWheelHold.reset();
+                ClearTask(pTask);
+            }
+        }
+    }
+
+    // 已有任务全部放回 _cache, 由 TransferTask 按新引擎重新加入; 调用时已持有 _lock
+    void SwitchEngine() {
+        while (!_queue.empty()) {
+            _cache.push(_queue.top());
+            _queue.pop();
+        }
+        _wheel.Clear([this](TimingWheelNode* pNode) {
+            auto pTask = static_cast<TimeTask*>(pNode);
+            _cache.push(std::move(pTask->pWheelHold));
+        });
+        _eEngine = _ePendingEngine;
+    }
+
+    // 投递模式下回调可能正在执行器线程上执行, 由回调执行完后自行清理
+    void ClearTask(const TimeTaskPtr& pTask) {
+        if (!_kExecutor) {
+            pTask->Clear();
+        }
+    }
+
+    // 任务被取消, 时间轮引擎下在下次 TransferTask 时从轮上摘下
+    void OnCancel(TimeTaskPtr pTask) {
+        AutoLock k(_lock);
+        if (_eEngine == eWheel) {
+            _cancel.emplace(std::move(pTask));
+        }
+    }
+
+    // 时间点转换成时间轮刻度(毫秒), bCeil 为 true 时向上取整, 保证任务不会提前触发
+    uint64_t ToTick(const TimePoint& nTime, bool bCeil = false) const {
+        if (nTime <= _nEpoch) {
+            return 0;
+        }
+        auto nDiff = nTime - _nEpoch;
+        auto nTick = std::chrono::duration_cast<MilliSeconds>(nDiff);
+        if (bCeil && nTick < nDiff) {
+            ++nTick;
         }
+        return (uint64_t)nTick.count();
     }
 
     // 新建任务
@@ -301,6 +627,20 @@ class Timer {
 
     Lock _lock;
     std::queue<TimeTaskPtr> _cache;
+    std::queue<TimeTaskPtr> _cancel;
     std::priority_queue<TimeTaskPtr, std::vector<TimeTaskPtr>, TimeTaskPtrCmp> _queue;
+    Engine _eEngine = eHeap;
+    Engine _ePendingEngine = eHeap; // SetEngine 请求的引擎, 由 TransferTask 切换
+    std::atomic<bool> _bCoarseClock = {false};
+    TimePoint _nNow;
+    static constexpr TimeDuration kMaxDriveWait = std::chrono::duration_cast<TimeDuration>(Seconds(60));
+    Executor _kExecutor;
+    Signal _signal;
+    std::atomic<bool> _bRunning = {false};
+    std::unique_ptr<std::thread> _pThread;
+    // 驱动线程预计醒来的时间
+    TimePoint _nWakeTime = TimePoint::max();
+    TimePoint _nEpoch;
+    TimingWheel _wheel;
 };
 } // namespace xs
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace xs {
+
+// 时间轮节点, 挂到时间轮上的对象继承它
+struct TimingWheelNode {
+    TimingWheelNode* pPrev = nullptr;
+    TimingWheelNode* pNext = nullptr;
+    // 到期刻度
+    uint64_t nExpireTick = 0;
+    int8_t nLevel = -1;
+
+    bool IsLinked() const {
+        return pNext != nullptr;
+    }
+};
+
+// 分层时间轮, 第 0 层 256 格, 第 1-4 层各 64 格, 共覆盖 2^32 个刻度, 更远的任务到达后重新插入
+// 插入, 删除 O(1), 推进每个刻度均摊 O(1)
+// 非线程安全, 只能在推进时间轮的线程上使用
+class TimingWheel {
+  public:
+    static constexpr int kRootBits = 8;
+    static constexpr int kLevelBits = 6;
+    static constexpr int kLevels = 4;
+    static constexpr uint64_t kRootSize = 1ull << kRootBits;
+    static constexpr uint64_t kLevelSize = 1ull << kLevelBits;
+    static constexpr uint64_t kRootMask = kRootSize - 1;
+    static constexpr uint64_t kLevelMask = kLevelSize - 1;
+    static constexpr uint64_t kMaxSpan = (1ull << (kRootBits + kLevels * kLevelBits)) - 1;
+    static constexpr uint64_t kNever = std::numeric_limits<uint64_t>::max();
+
+    explicit TimingWheel(uint64_t nStartTick = 0)
+        : _nCurTick(nStartTick) {
+        for (auto& kHead : _root) {
+            InitHead(&kHead);
+        }
+        for (auto& kLevel : _levels) {
+            for (auto& kHead : kLevel) {
+                InitHead(&kHead);
+            }
+        }
+    }
+
+    TimingWheel(const TimingWheel&) = delete;
+    TimingWheel& operator=(const TimingWheel&) = delete;
+
+    // 按 pNode->nExpireTick 插入, 已过期的节点在下次推进时到期
+    void Add(TimingWheelNode* pNode) {
+        if (pNode->IsLinked()) {
+            Remove(pNode);
+        }
+        Insert(pNode);
+    }
+
+    void Remove(TimingWheelNode* pNode) {
+        if (!pNode->IsLinked()) {
+            return;
+        }
+        if (pNode->nLevel == 0) {
+            --_nRootCount;
+        }
+        Unlink(pNode);
+        --_nCount;
+    }
+
+    // 推进到 nNowTick (包含), 到期节点先摘下再交给 fnExpire(TimingWheelNode*)
+    template <typename F>
+    void Advance(uint64_t nNowTick, F&& fnExpire) {
+        while (_nCurTick <= nNowTick) {
+            if (_nCount == 0) {
+                _nCurTick = nNowTick + 1;
+                break;
+            }
+            uint64_t nIndex = _nCurTick & kRootMask;
+            if (nIndex == 0) {
+                Cascade();
+            }
+            if (_nRootCount == 0) {
+                // 第 0 层为空, 直接跳到下一次降级
+                uint64_t nNext = (_nCurTick | kRootMask) + 1;
+                _nCurTick = nNext <= nNowTick + 1 ? nNext : nNowTick + 1;
+                continue;
+            }
+
+            TimingWheelNode kList;
+            Splice(&_root[nIndex], &kList);
+            while (kList.pNext != &kList) {
+                TimingWheelNode* pNode = kList.pNext;
+                Unlink(pNode);
+                --_nRootCount;
+                --_nCount;
+                if (pNode->nExpireTick > _nCurTick) {
+                    // 超出覆盖范围被截断的节点
+                    Insert(pNode);
+                } else {
+                    fnExpire(pNode);
+                }
+            }
+            ++_nCurTick;
+        }
+    }
+
+    // 下一次可能有节点到期的刻度, 不会晚于真实到期刻度; 为空时返回 kNever
+    uint64_t NextExpireTick() const {
+        if (_nCount == 0) {
+            return kNever;
+        }
+        if (_nRootCount > 0) {
+            for (uint64_t i = 0; i < kRootSize; i++) {
+                uint64_t nTick = _nCurTick + i;
+                const TimingWheelNode& kHead = _root[nTick & kRootMask];
+                if (kHead.pNext != &kHead) {
+                    return nTick;
+                }
+            }
+        }
+        return (_nCurTick | kRootMask) + 1;
+    }
+
+    // 摘下所有节点并交给 fn(TimingWheelNode*)
+    template <typename F>
+    void Clear(F&& fn) {
+        auto fnClearHead = [&](TimingWheelNode* pHead) {
+            while (pHead->pNext != pHead) {
+                TimingWheelNode* pNode = pHead->pNext;
+                Unlink(pNode);
+                fn(pNode);
+            }
+        };
+        for (auto& kHead : _root) {
+            fnClearHead(&kHead);
+        }
+        for (auto& kLevel : _levels) {
+            for (auto& kHead : kLevel) {
+                fnClearHead(&kHead);
+            }
+        }
+        _nCount = 0;
+        _nRootCount = 0;
+    }
+
+    size_t Size() const {
+        return _nCount;
+    }
+
+    // 下一个待处理的刻度
+    uint64_t CurrentTick() const {
+        return _nCurTick;
+    }
+
+  private:
+    static void InitHead(TimingWheelNode* pHead) {
+        pHead->pPrev = pHead;
+        pHead->pNext = pHead;
+    }
+
+    static void Unlink(TimingWheelNode* pNode) {
+        pNode->pPrev->pNext = pNode->pNext;
+        pNode->pNext->pPrev = pNode->pPrev;
+        pNode->pPrev = nullptr;
+        pNode->pNext = nullptr;
+        pNode->nLevel = -1;
+    }
+
+    static void LinkTail(TimingWheelNode* pHead, TimingWheelNode* pNode) {
+        pNode->pPrev = pHead->pPrev;
+        pNode->pNext = pHead;
+        pHead->pPrev->pNext = pNode;
+        pHead->pPrev = pNode;
+    }
+
+    // 把 pFrom 的整条链表移到空表 pTo
+    static void Splice(TimingWheelNode* pFrom, TimingWheelNode* pTo) {
+        if (pFrom->pNext == pFrom) {
+            InitHead(pTo);
+            return;
+        }
+        pTo->pNext = pFrom->pNext;
+        pTo->pPrev = pFrom->pPrev;
+        pTo->pNext->pPrev = pTo;
+        pTo->pPrev->pNext = pTo;
+        InitHead(pFrom);
+    }
+
+    void Insert(TimingWheelNode* pNode) {
+        uint64_t nExpire = pNode->nExpireTick < _nCurTick ? _nCurTick : pNode->nExpireTick;
+        uint64_t nDiff = nExpire - _nCurTick;
+        if (nDiff < kRootSize) {
+            pNode->nLevel = 0;
+            LinkTail(&_root[nExpire & kRootMask], pNode);
+            ++_nRootCount;
+            ++_nCount;
+            return;
+        }
+        if (nDiff > kMaxSpan) {
+            nExpire = _nCurTick + kMaxSpan;
+        }
+        int nLevel = 0;
+        while (nLevel < kLevels - 1 && nDiff >= (1ull << (kRootBits + (nLevel + 1) * kLevelBits))) {
+            ++nLevel;
+        }
+        uint64_t nIndex = (nExpire >> (kRootBits + nLevel * kLevelBits)) & kLevelMask;
+        pNode->nLevel = (int8_t)(nLevel + 1);
+        LinkTail(&_levels[nLevel][nIndex], pNode);
+        ++_nCount;
+    }
+
+    // 第 0 层转完一圈时, 把上层当前格的节点重新分配到下层
+    void Cascade() {
+        for (int nLevel = 0; nLevel < kLevels; nLevel++) {
+            uint64_t nIndex = (_nCurTick >> (kRootBits + nLevel * kLevelBits)) & kLevelMask;
+            TimingWheelNode kList;
+            Splice(&_levels[nLevel][nIndex], &kList);
+            while (kList.pNext != &kList) {
+                TimingWheelNode* pNode = kList.pNext;
+                Unlink(pNode);
+                --_nCount;
+                Insert(pNode);
+            }
+            if (nIndex != 0) {
+                break;
+            }
+        }
+    }
+
+    uint64_t _nCurTick = 0;
+    size_t _nCount = 0;
+    size_t _nRootCount = 0;
+    TimingWheelNode _root[kRootSize];
+    TimingWheelNode _levels[kLevels][kLevelSize];
+};
+} // namespace xs
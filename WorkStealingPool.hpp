@@ -0,0 +1,235 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Signal.hpp"
+#include "Future.hpp"
+#include "InplaceTask.hpp"
+#include "Coroutine.hpp"
+
+namespace xs {
+
+// 工作窃取线程池, 接口与 TaskPool 一致
+// 每个工作线程有自己的任务队列: 自己从尾部取(LIFO), 其它线程从头部窃取(FIFO)
+// 工作线程内 PushTask 的任务进入本线程队列, 外部线程的任务轮流分派到各工作线程
+class WorkStealingPool {
+  public:
+    using TaskFunc = InplaceTask;
+
+    WorkStealingPool(int cnt = (int)std::thread::hardware_concurrency()) {
+        if (cnt <= 0) {
+            cnt = 1;
+        }
+        m_bRun = true;
+        for (int i = 0; i < cnt; i++) {
+            m_Workers.emplace_back(std::make_unique<Worker>());
+        }
+        for (int i = 0; i < cnt; i++) {
+            auto pThread = std::make_unique<std::thread>(std::bind(&WorkStealingPool::OnWork, this, i));
+            m_Threads.emplace_back(std::move(pThread));
+        }
+    }
+
+    virtual ~WorkStealingPool() {
+        Stop();
+    }
+
+    bool PushTask(TaskFunc func) {
+        if (!func) {
+            return false;
+        }
+        Worker* pWorker = CurrentWorker();
+        if (pWorker) {
+            // 正在执行的任务派生的子任务进入本线程队列, 该线程退出前会执行完
+            Enqueue(pWorker, std::move(func));
+            return true;
+        }
+        // 停止后不再接受外部任务; 先登记再检查 m_bRun, 与 Stop 配对, Stop 等登记清零后才让工作线程退出
+        m_nPushing.fetch_add(1, std::memory_order_seq_cst);
+        if (!m_bRun.load(std::memory_order_seq_cst)) {
+            m_nPushing.fetch_sub(1, std::memory_order_release);
+            return false;
+        }
+        size_t nIndex = m_nNextWorker.fetch_add(1, std::memory_order_relaxed) % m_Workers.size();
+        Enqueue(m_Workers[nIndex].get(), std::move(func));
+        m_nPushing.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    // 投递 fn(args...), 返回其结果的 Future
+    template <typename F, typename... Args>
+    auto Submit(F&& fn, Args&&... args) {
+        return SubmitTo(*this, std::forward<F>(fn), std::forward<Args>(args)...);
+    }
+
+#ifdef XS_HAS_COROUTINE
+    // co_await pool.Schedule() 切换到工作线程继续执行
+    auto Schedule() {
+        return ScheduleOn(*this);
+    }
+#endif
+
+    size_t WorkerCount() const {
+        return m_Workers.size();
+    }
+
+  protected:
+    // nSize 在锁内更新, 供空闲检查和窃取前无锁判断队列是否为空
+    struct alignas(64) Worker {
+        std::mutex kLock;
+        std::deque<TaskFunc> kTasks;
+        std::atomic<size_t> nSize = {0};
+    };
+
+    struct WorkerContext {
+        WorkStealingPool* pPool = nullptr;
+        Worker* pWorker = nullptr;
+    };
+
+    static WorkerContext& CurrentContext() {
+        static thread_local WorkerContext kContext;
+        return kContext;
+    }
+
+    // 当前线程属于本线程池时返回其 Worker
+    Worker* CurrentWorker() {
+        WorkerContext& kContext = CurrentContext();
+        return kContext.pPool == this ? kContext.pWorker : nullptr;
+    }
+
+    void Enqueue(Worker* pWorker, TaskFunc&& func) {
+        {
+            std::lock_guard<std::mutex> kLock(pWorker->kLock);
+            pWorker->kTasks.push_back(std::move(func));
+            pWorker->nSize.store(pWorker->kTasks.size(), std::memory_order_relaxed);
+        }
+        WakeIdle();
+    }
+
+    bool PopLocal(Worker* pWorker, TaskFunc& func) {
+        if (pWorker->nSize.load(std::memory_order_relaxed) == 0) {
+            return false;
+        }
+        std::lock_guard<std::mutex> kLock(pWorker->kLock);
+        if (pWorker->kTasks.empty()) {
+            return false;
+        }
+        func = std::move(pWorker->kTasks.back());
+        pWorker->kTasks.pop_back();
+        pWorker->nSize.store(pWorker->kTasks.size(), std::memory_order_relaxed);
+        return true;
+    }
+
+    bool Steal(size_t nSelf, uint32_t& nSeed, TaskFunc& func) {
+        size_t nCount = m_Workers.size();
+        // xorshift 随机选起点, 避免所有空闲线程同时窃取同一个队列
+        nSeed ^= nSeed << 13;
+        nSeed ^= nSeed >> 17;
+        nSeed ^= nSeed << 5;
+        size_t nStart = nSeed % nCount;
+        for (size_t i = 0; i < nCount; i++) {
+            size_t nVictim = (nStart + i) % nCount;
+            if (nVictim == nSelf) {
+                continue;
+            }
+            Worker* pVictim = m_Workers[nVictim].get();
+            if (pVictim->nSize.load(std::memory_order_relaxed) == 0) {
+                continue;
+            }
+            std::lock_guard<std::mutex> kLock(pVictim->kLock);
+            if (!pVictim->kTasks.empty()) {
+                func = std::move(pVictim->kTasks.front());
+                pVictim->kTasks.pop_front();
+                pVictim->nSize.store(pVictim->kTasks.size(), std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 不加锁, 调用前已有 seq_cst 屏障, 与 PushTask 写入 nSize 后的屏障配对
+    bool HasTask() {
+        for (auto& pWorker : m_Workers) {
+            if (pWorker->nSize.load(std::memory_order_relaxed) > 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WakeIdle() {
+        // 与 OnWork 中登记空闲后的检查配对, 保证不会漏唤醒
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_nIdle.load(std::memory_order_relaxed) > 0) {
+            m_kSignal.Notify();
+        }
+    }
+
+    void OnWork(size_t nIndex) {
+        Worker* pWorker = m_Workers[nIndex].get();
+        WorkerContext& kContext = CurrentContext();
+        kContext.pPool = this;
+        kContext.pWorker = pWorker;
+
+        uint32_t nSeed = (uint32_t)nIndex * 2654435761u + 1;
+        TaskFunc func;
+        while (true) {
+            if (PopLocal(pWorker, func) || Steal(nIndex, nSeed, func)) {
+                func();
+                func = nullptr;
+                continue;
+            }
+            if (m_bExit.load(std::memory_order_acquire)) {
+                break;
+            }
+
+            m_nIdle.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (HasTask() || m_bExit.load(std::memory_order_relaxed)) {
+                m_nIdle.fetch_sub(1, std::memory_order_relaxed);
+                continue;
+            }
+            m_kSignal.Wait();
+            m_nIdle.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        kContext.pPool = nullptr;
+        kContext.pWorker = nullptr;
+    }
+
+    // 停止前会执行完已提交的任务
+    void Stop() {
+        if (!m_bRun.exchange(false)) {
+            return;
+        }
+        // 等已经通过 m_bRun 检查的外部 PushTask 把任务放进队列
+        while (m_nPushing.load(std::memory_order_acquire) > 0) {
+            std::this_thread::yield();
+        }
+        m_bExit.store(true, std::memory_order_release);
+        m_kSignal.Notify((int32_t)m_Threads.size());
+
+        for (auto& pThread : m_Threads) {
+            if (pThread->joinable()) {
+                pThread->join();
+            }
+        }
+    }
+
+    std::atomic<bool> m_bRun;
+    // Stop 确认没有进行中的外部 PushTask 后置位, 工作线程取不到任务时才退出
+    std::atomic<bool> m_bExit = {false};
+    std::atomic<int32_t> m_nPushing = {0};
+    std::atomic<size_t> m_nNextWorker = {0};
+    std::atomic<int32_t> m_nIdle = {0};
+    Signal m_kSignal;
+    std::vector<std::unique_ptr<Worker>> m_Workers;
+    std::vector<std::unique_ptr<std::thread>> m_Threads;
+};
+} // namespace xs
@@ -1,10 +1,24 @@
 #pragma once
 
+#include <cstddef>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <set>
 #include <memory>
+#include <optional>
+#include <iterator>
+#include <algorithm>
+#include <charconv>
+#include <initializer_list>
+#include <type_traits>
+
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define XS_REDIS_PMR 1
+#endif
 
 namespace xs {
 
@@ -31,9 +45,75 @@ class HiRedisHelper {
     typedef std::shared_ptr<TSSetValue> TSSetValuePtr;
     typedef std::vector<TSSetValuePtr> TSSet;
     typedef std::map<TKey, TValuePtr> THash;
+    // 批量命令的 key/field 序列, 排除单个字符串以免被当成字符序列
+    template <typename T>
+    using EnableRange = typename std::enable_if<!std::is_convertible<const T&, std::string_view>::value, int>::type;
+
+    // 批量读取的结果, 与输入的 key/field 一一对应, 不存在的为 nullopt
+    typedef std::optional<TValue> TOptValue;
+    typedef std::vector<TOptValue> TOptValues;
 
     using RedisReplyPtr = std::shared_ptr<redisReply>;
 
+    struct ReplyDeleter {
+        void operator()(redisReply* p) const {
+            FreeReply(p);
+        }
+    };
+    using RedisReplyUPtr = std::unique_ptr<redisReply, ReplyDeleter>;
+
+    // argv 命令参数: 字符串以 string_view 引用, 不复制且二进制安全; 整数就地格式化
+    // 只用于 CommandArgv({...}) 这类临时参数列表, 引用的字符串须在调用期间有效
+    class Arg {
+      public:
+        Arg(std::string_view sv)
+            : _sv(sv) {
+        }
+
+        Arg(const std::string& str)
+            : _sv(str) {
+        }
+
+        Arg(const char* sz)
+            : _sv(sz) {
+        }
+
+        template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+        Arg(T n) {
+            auto kRet = std::to_chars(_szNum, _szNum + sizeof(_szNum), n);
+            _sv = std::string_view(_szNum, kRet.ptr - _szNum);
+        }
+
+        // 整数参数指向自身缓冲区, 不能复制
+        Arg(const Arg&) = delete;
+        Arg& operator=(const Arg&) = delete;
+
+        std::string_view View() const {
+            return _sv;
+        }
+
+      private:
+        std::string_view _sv;
+        char _szNum[24];
+    };
+
+#ifdef XS_REDIS_PMR
+    // 结果从传入容器的 memory_resource 分配, 配合 ArenaResource 可随请求一次性释放
+    typedef std::pmr::string TPmrValue;
+    typedef std::pmr::vector<TPmrValue> TPmrValues;
+    typedef std::pmr::map<TPmrValue, TPmrValue> TPmrHash;
+#endif
+
+    HiRedisHelper() {}
+
+    ~HiRedisHelper() {
+        Close();
+    }
+
+    // 持有 redisContext, 不可复制
+    HiRedisHelper(const HiRedisHelper&) = delete;
+    HiRedisHelper& operator=(const HiRedisHelper&) = delete;
+
     bool Connect(const std::string& strAddress, const std::string& strPass = "") {
         auto nFind = strAddress.find(":");
         if (nFind == std::string::npos) {
@@ -79,18 +159,37 @@ class HiRedisHelper {
         return bRet;
     }
 
+    // 用上次 Connect 的地址和密码重新连接
+    bool Reconnect() {
+        std::string strHost = _strHost;
+        std::string strPass = _strPass;
+        return Connect(strHost, _nPort, _nTimeout, strPass);
+    }
+
+    // 连接存在且没有出过 I/O 错误; 不发送命令, 需要确认对端存活用 Ping
+    bool IsConnected() const {
+        return NULL != _pCtx && 0 == _pCtx->err;
+    }
+
+    void Close() {
+        if (NULL != _pCtx) {
+            redisFree(_pCtx);
+            _pCtx = NULL;
+        }
+    }
+
   public:
     //connection
     // AUTH
     bool Auth(const TKey& pass) {
-        auto pReply = CommandWrap("AUTH %s", _strPass.c_str());
-        return CheckReply(pReply);
+        auto pReply = CommandArgv({"AUTH", _strPass});
+        return CheckReply(pReply.get());
     }
 
     // PING
     bool Ping() {
-        auto pReply = CommandWrap("PING");
-        return CheckReply(pReply);
+        auto pReply = CommandArgv({"PING"});
+        return ReplyPong(pReply.get());
     }
 
     // ECHO
@@ -103,23 +202,63 @@ class HiRedisHelper {
     // BITOP         bool bitop( const BITOP operation, const string& destkey, const KEYS& keys, int& lenght);
     // BITPOS        bool bitpos( const string& key, const int bit, int64_t& pos, const int start = 0, const int end = 0);
     bool Decr(const TKey& key, int64_t& result) {
-        return CommandInteger(result, "DECR %s", key.c_str());
+        return ReplyInteger(CommandArgv({"DECR", key}).get(), result);
     }
     // DECRBY        bool decrby( const string& key, const int by, int64_t& result);
     // GET
     bool Get(const TKey& key, TValue& value) {
-        return CommandString(value, "GET %s", key.c_str());
+        return ReplyString(CommandArgv({"GET", key}).get(), value);
     }
     // GETBIT        bool getbit( const string& key, const int& offset, int& bit);
     // GETRANGE      bool getrange( const string& key, const int start, const int end, string& out);
     // GETSET        bool getset( const string& key, const string& newValue, string& oldValue);
     bool Incr(const TKey& key, int64_t& result) {
-        return CommandInteger(result, "INCR %s", key.c_str());
+        return ReplyInteger(CommandArgv({"INCR", key}).get(), result);
     }
     // INCRBY        bool incrby( const string& key, const int by, int64_t& result);
     // INCRBYFLOAT
-    // MGET          bool mget(const DBIArray& dbi, const KEYS &  keys, ReplyData& vDdata);
-    // MSET          bool mset(const DBIArray& dbi, const VDATA& data);
+    // MGET
+    // keys 为字符串序列: vector/span/array 等, 元素为 string/string_view/const char*
+    // 超过 SetBatchSize 的 key 拆成多条命令, 一次往返发出, 单个回复的大小有上限
+    template <typename TKeyRange, EnableRange<TKeyRange> = 0>
+    bool MGet(const TKeyRange& keys, TOptValues& values) {
+        values.clear();
+        values.resize(std::size(keys));
+        return MGet(keys, [&values](size_t nIndex, std::string_view value) {
+            values[nIndex].emplace(value);
+        });
+    }
+
+    // fnVisit(nIndex, value) 只对存在的 key 调用, value 指向回复内部, 回调返回后失效
+    template <typename TKeyRange, typename F, EnableRange<TKeyRange> = 0>
+    bool MGet(const TKeyRange& keys, F&& fnVisit) {
+        auto iter = std::begin(keys);
+        return BatchCommand(std::size(keys), [this, &iter](size_t nCount) {
+            ArgvPush("MGET");
+            for (size_t i = 0; i < nCount; i++, ++iter) {
+                ArgvPush(BatchView(*iter));
+            }
+        }, [&fnVisit](size_t nBegin, const redisReply* pReply) {
+            return ReplyVisit(pReply, nBegin, fnVisit);
+        });
+    }
+
+    // MSET
+    // kvs 为 pair 序列: vector<pair<K, V>>/span/map/THash 等
+    // 拆成多条命令时整体不再是原子的, 某一批失败其它批仍会写入
+    template <typename TPairRange, EnableRange<TPairRange> = 0>
+    bool MSet(const TPairRange& kvs) {
+        auto iter = std::begin(kvs);
+        return BatchCommand(std::size(kvs), [this, &iter](size_t nCount) {
+            ArgvPush("MSET");
+            for (size_t i = 0; i < nCount; i++, ++iter) {
+                ArgvPush(BatchView(iter->first));
+                ArgvPush(BatchView(iter->second));
+            }
+        }, [](size_t, const redisReply* pReply) {
+            return ReplyBool(pReply);
+        });
+    }
     // MSETNX
     // PSETEX        bool psetex( const string& key, const int milliseconds, const string& value);
     // SET
@@ -130,9 +269,9 @@ class HiRedisHelper {
 
     bool Set(const TKey& key, const char* value, int len, const int second = 0) {
         if (0 == second) {
-            return CommandBool("SET %s %b", key.c_str(), value, len);
+            return ReplyBool(CommandArgv({"SET", key, std::string_view(value, len)}).get());
         } else {
-            return CommandBool("SET %s %b EX %d", key.c_str(), value, len, second);
+            return ReplyBool(CommandArgv({"SET", key, std::string_view(value, len), "EX", second}).get());
         }
     }
 
@@ -145,9 +284,26 @@ class HiRedisHelper {
     // DEL
     bool Del(const TKey& key) {
         int64_t nDel = 0;
-        return CommandInteger(nDel, "DEL %s", key.c_str());
+        return ReplyInteger(CommandArgv({"DEL", key}).get(), nDel);
+    }
+
+    // 多个 key 的 DEL, nCount 为实际删除的个数
+    template <typename TKeyRange, EnableRange<TKeyRange> = 0>
+    bool Del(const TKeyRange& keys, int64_t& nCount) {
+        nCount = 0;
+        auto iter = std::begin(keys);
+        return BatchCommand(std::size(keys), [this, &iter](size_t nNum) {
+            ArgvPush("DEL");
+            for (size_t i = 0; i < nNum; i++, ++iter) {
+                ArgvPush(BatchView(*iter));
+            }
+        }, [&nCount](size_t, const redisReply* pReply) {
+            int64_t nDel = 0;
+            bool bOK = ReplyInteger(pReply, nDel);
+            nCount += nDel;
+            return bOK;
+        });
     }
-    //bool del(const DBIArray& dbi, const KEYS &  vkey, int64_t& count);
     // DUMP
     // EXISTS         bool exists( const string& key);
     // EXPIRE         bool expire( const string& key, const unsigned int second);
@@ -175,46 +331,93 @@ class HiRedisHelper {
 
     // HDEL
     bool HDel(const TKey& key, const TField& filed, int64_t* num) {
-        return CommandInteger(*num, "HDEL %s %s", key.c_str(), filed.c_str());
+        return ReplyInteger(CommandArgv({"HDEL", key, filed}).get(), *num);
     }
     //bool hdel( const string& key, const KEYS& vfiled, int64_t& num);
     // HEXISTS        bool hexist( const string& key, const string& filed);
     // HGET
 
     bool HGet(const TKey& key, const TField& filed, TValue* value) {
-        return CommandString(*value, "HGET %s %s", key.c_str(), filed.c_str());
+        return ReplyString(CommandArgv({"HGET", key, filed}).get(), *value);
     }
 
     // HGETALL
-    bool HGetAll(const TKey& key, THash ret) {
-        bool bOK = CommandHash(ret, "HGETALL %s", key.c_str());
+    bool HGetAll(const TKey& key, THash& ret) {
+        bool bOK = ReplyHash(CommandArgv({"HGETALL", key}).get(), ret);
         return bOK;
     }
+#ifdef XS_REDIS_PMR
+    bool HGetAll(const TKey& key, TPmrHash& ret) {
+        return ReplyHash(CommandArgv({"HGETALL", key}).get(), ret);
+    }
+#endif
     // HINCRBY
     bool HIncrby(const TKey& key, const TField& field, int32_t increment, int64_t& value) {
-        return CommandInteger(value, "HINCRBY %s %s %d", key.c_str(), field.c_str(), increment);
+        return ReplyInteger(CommandArgv({"HINCRBY", key, field, increment}).get(), value);
     }
     // HINCRBYFLOAT   bool hincrbyfloat( const string& key, const string& filed, const float increment, float& value);
     bool HKeys(const TKey& key, TValues* values) {
-        return CommandArray(*values, "HKEYS %s", key.c_str());
+        return ReplyArray(CommandArgv({"HKEYS", key}).get(), *values);
+    }
+#ifdef XS_REDIS_PMR
+    bool HKeys(const TKey& key, TPmrValues& values) {
+        return ReplyArray(CommandArgv({"HKEYS", key}).get(), values);
     }
+#endif
     // HLEN
     bool HLen(const TKey& key, int64_t* count) {
-        return CommandInteger(*count, "HLEN %s", key.c_str());
+        return ReplyInteger(CommandArgv({"HLEN", key}).get(), *count);
+    }
+    // HMGET, 参数与分批同 MGet
+    template <typename TFieldRange, EnableRange<TFieldRange> = 0>
+    bool HMGet(const TKey& key, const TFieldRange& fields, TOptValues& values) {
+        values.clear();
+        values.resize(std::size(fields));
+        return HMGet(key, fields, [&values](size_t nIndex, std::string_view value) {
+            values[nIndex].emplace(value);
+        });
+    }
+
+    template <typename TFieldRange, typename F, EnableRange<TFieldRange> = 0>
+    bool HMGet(const TKey& key, const TFieldRange& fields, F&& fnVisit) {
+        auto iter = std::begin(fields);
+        return BatchCommand(std::size(fields), [this, &key, &iter](size_t nCount) {
+            ArgvPush("HMGET");
+            ArgvPush(key);
+            for (size_t i = 0; i < nCount; i++, ++iter) {
+                ArgvPush(BatchView(*iter));
+            }
+        }, [&fnVisit](size_t nBegin, const redisReply* pReply) {
+            return ReplyVisit(pReply, nBegin, fnVisit);
+        });
+    }
+
+    // HMSET, 参数与分批同 MSet
+    template <typename TPairRange, EnableRange<TPairRange> = 0>
+    bool HMSet(const TKey& key, const TPairRange& kvs) {
+        auto iter = std::begin(kvs);
+        return BatchCommand(std::size(kvs), [this, &key, &iter](size_t nCount) {
+            ArgvPush("HMSET");
+            ArgvPush(key);
+            for (size_t i = 0; i < nCount; i++, ++iter) {
+                ArgvPush(BatchView(iter->first));
+                ArgvPush(BatchView(iter->second));
+            }
+        }, [](size_t, const redisReply* pReply) {
+            return ReplyBool(pReply);
+        });
     }
-    // HMGET          bool hmget( const string& key, const KEYS& filed, ArrayReply& array);
-    // HMSET          bool hmset( const string& key, const VDATA& vData);
     // HSCAN
 
     bool HSet(const TKey& key, const TField& filed, const TValue& value) {
         int64_t retval = 0;
-        bool bOK = CommandInteger(retval, "HSET %s %s %b", key.c_str(), filed.c_str(), value.c_str(), value.length());
+        bool bOK = ReplyInteger(CommandArgv({"HSET", key, filed, value}).get(), retval);
         return bOK && retval == 1;
     }
 
     bool HSetnx(const TKey& key, const TField& filed, const TValue& value) {
         int64_t retval = 0;
-        bool bOK = CommandInteger(retval, "HSETNX %s %s %b", key.c_str(), filed.c_str(), value.c_str(), value.length());
+        bool bOK = ReplyInteger(CommandArgv({"HSETNX", key, filed, value}).get(), retval);
         return bOK && retval == 1;
     }
 
@@ -238,7 +441,7 @@ class HiRedisHelper {
     // RPUSH
 
     bool RPush(const TKey& key, const TValue& value, int64_t& length) {
-        return CommandInteger(length, "RPUSH %s %s", key.c_str(), value.c_str());
+        return ReplyInteger(CommandArgv({"RPUSH", key, value}).get(), length);
     }
 
     // RPUSHX         bool rpushx( const string& key, const string& value, int64_t& length);
@@ -261,12 +464,12 @@ class HiRedisHelper {
 
     bool SAdd(const TKey& key, const TValue& value) {
         int64_t retval;
-        bool bOK = CommandInteger(retval, "SADD %s %b", key.c_str(), value.c_str(), value.length());
+        bool bOK = ReplyInteger(CommandArgv({"SADD", key, value}).get(), retval);
         return bOK && retval == 1;
     }
 
     bool SCard(const TKey& key, int64_t& nCount) {
-        return CommandInteger(nCount, "SCARD %s", key.c_str());
+        return ReplyInteger(CommandArgv({"SCARD", key}).get(), nCount);
     }
     // SDIFF          bool sdiff(const DBIArray& dbi, const KEYS& vKkey, VALUES& vValue);
     // SDIFFSTORE     bool sdiffstore( const KEY& destinationkey, const DBIArray& vdbi, const KEYS& vkey, int64_t& count);
@@ -275,11 +478,16 @@ class HiRedisHelper {
     // SISMEMBER      bool sismember( const KEY& key, const VALUE& member);
     // SMEMBERS       bool smembers( const KEY& key, VALUES& vValue);
     bool SMembers(const TKey& key, TValues& values) {
-        return CommandArray(values, "SMEMBERS %s", key.c_str());
+        return ReplyArray(CommandArgv({"SMEMBERS", key}).get(), values);
+    }
+#ifdef XS_REDIS_PMR
+    bool SMembers(const TKey& key, TPmrValues& values) {
+        return ReplyArray(CommandArgv({"SMEMBERS", key}).get(), values);
     }
+#endif
     // SMOVE          bool smove( const KEY& srckey, const KEY& deskey, const VALUE& member);
     bool SPop(const TKey& key, TValue& value) {
-        return CommandString(value, "SPOP %s", key.c_str());
+        return ReplyString(CommandArgv({"SPOP", key}).get(), value);
     }
     // SRANDMEMBER    bool srandmember( const KEY& key, VALUES& vmember, int num = 0);
     // SREM           bool srem( const KEY& key, const VALUES& vmembers, int64_t& count);
@@ -290,18 +498,18 @@ class HiRedisHelper {
     // ZADD
     bool ZAdd(const TKey& key, const TField& value, const int32_t& score) {
         int64_t retval = 0;
-        bool bOK = CommandInteger(retval, "ZADD %s %d %s", key.c_str(), score, value.c_str());
+        bool bOK = ReplyInteger(CommandArgv({"ZADD", key, score, value}).get(), retval);
         return bOK;
     }
 
     // ZCARD
     bool ZCard(const TKey& key, int64_t* num) {
-        return CommandInteger(*num, "ZCARD %s", key.c_str());
+        return ReplyInteger(CommandArgv({"ZCARD", key}).get(), *num);
     }
 
     bool ZCount(const TKey& key, int32_t begin, int32_t end, int64_t* count) {
         int64_t retval = 0;
-        bool bOK = CommandInteger(retval, "ZCOUNT %s %d %d", key.c_str(), begin, end);
+        bool bOK = ReplyInteger(CommandArgv({"ZCOUNT", key, begin, end}).get(), retval);
         *count = retval;
         return bOK;
     }
@@ -309,7 +517,7 @@ class HiRedisHelper {
     // ZINTERSTORE
     // ZRANGE
     bool ZRangeWithScore(const TKey& key, int32_t start, int32_t end, TSSet* vValues) {
-        bool bOK = CommandSSet(*vValues, "ZRANGE %s %d %d WITHSCORES", key.c_str(), start, end);
+        bool bOK = ReplySSet(CommandArgv({"ZRANGE", key, start, end, "WITHSCORES"}).get(), *vValues);
         return bOK;
     }
     // ZRANGEBYSCORE
@@ -318,35 +526,40 @@ class HiRedisHelper {
 
     bool ZRem(const TKey& key, const TField& field) {
         int64_t nCount = 0;
-        bool bOK = CommandInteger(nCount, "ZREM %s %s", key.c_str(), field.c_str());
+        bool bOK = ReplyInteger(CommandArgv({"ZREM", key, field}).get(), nCount);
         return bOK;
     }
     // ZREMRANGEBYRANK
     bool ZRemRangeByRank(const TKey& key, int32_t nBegin, int32_t nEnd, int64_t* num) {
-        bool bOK = CommandInteger(*num, "ZREMRANGEBYRANK %s %d %d", key.c_str(), nBegin, nEnd);
+        bool bOK = ReplyInteger(CommandArgv({"ZREMRANGEBYRANK", key, nBegin, nEnd}).get(), *num);
         return bOK;
     }
     // ZREMRANGEBYSCORE
     bool ZRemRangeByScore(const TKey& key, int32_t nBegin, int32_t nEnd, int64_t* num) {
-        bool bOK = CommandInteger(*num, "ZREMRANGEBYSCORE %s %d %d", key.c_str(), nBegin, nEnd);
+        bool bOK = ReplyInteger(CommandArgv({"ZREMRANGEBYSCORE", key, nBegin, nEnd}).get(), *num);
         return bOK;
     }
     // ZREVRANGE
     bool ZRevrangeWithScore(const TKey& key, int start, int end, TSSet* vValues) {
-        auto bOK = CommandSSet(*vValues, "ZREVRANGE %s %d %d WITHSCORES", key.c_str(), start, end);
+        auto bOK = ReplySSet(CommandArgv({"ZREVRANGE", key, start, end, "WITHSCORES"}).get(), *vValues);
         return bOK;
     }
 
     bool ZRevrange(const TKey& key, int start, int end, TValues* vValues) {
-        auto bOK = CommandArray(*vValues, "ZREVRANGE %s %d %d", key.c_str(), start, end);
+        auto bOK = ReplyArray(CommandArgv({"ZREVRANGE", key, start, end}).get(), *vValues);
         return bOK;
     }
+#ifdef XS_REDIS_PMR
+    bool ZRevrange(const TKey& key, int start, int end, TPmrValues& vValues) {
+        return ReplyArray(CommandArgv({"ZREVRANGE", key, start, end}).get(), vValues);
+    }
+#endif
     // ZREVRANGEBYSCORE
     // ZREVRANK           bool zrevrank( const string& key, const string &member, int64_t& rank);
     // ZSCAN
     // ZSCORE
     bool Zscore(const TKey& key, const TField& member, TValue& score) {
-        auto bOK = CommandString(score, "ZSCORE %s %s", key.c_str(), member.c_str());
+        auto bOK = ReplyString(CommandArgv({"ZSCORE", key, member}).get(), score);
         return bOK;
     }
     // ZUNIONSTORE
@@ -363,46 +576,297 @@ class HiRedisHelper {
     // MULTI
     // UNWATCH
     // WATCH
-    template <typename... Args>
-    bool CommandBool(const char* szFmt, Args... args) {
-        bool bRet = false;
-        auto pReply = CommandWrap(szFmt, std::forward<Args>(args)...);
-        if (CheckReply(pReply)) {
-            if (REDIS_REPLY_STATUS == pReply->type) {
-                bRet = true;
-            } else {
-                bRet = (pReply->integer == 1) ? true : false;
+
+    // 管道: 命令先用 redisAppendCommand 写入连接的输出缓冲, Exec 时一次写出,
+    // 再按提交顺序读回结果, N 条命令只需一次往返
+    // 输出参数必须在 Exec 之前保持有效, 传 nullptr 表示只关心是否成功; Exec 之前不要在同一连接上执行其它命令或重连
+    //   HiRedisHelper::Pipeline kPipe(kRedis);
+    //   for (auto& kItem : vecItems) kPipe.HSet(key, kItem.first, kItem.second);
+    //   kPipe.Get(key, &strValue);
+    //   bool bAllOK = kPipe.Exec();
+    class Pipeline {
+      public:
+        explicit Pipeline(HiRedisHelper& kRedis)
+            : _kRedis(kRedis) {
+        }
+
+        // 未 Exec 的命令已经进入连接缓冲, 必须把回复读掉, 否则后续命令会错位
+        ~Pipeline() {
+            if (!_vecSlots.empty()) {
+                Exec();
             }
-        } else {
-            SetErrInfo(pReply);
         }
-        return bRet;
+
+        Pipeline(const Pipeline&) = delete;
+        Pipeline& operator=(const Pipeline&) = delete;
+
+        // 任意命令, 服务端没有返回错误即为成功
+        template <typename... Args>
+        Pipeline& Command(const char* szFmt, Args... args) {
+            return Append(eReplyAny, nullptr, szFmt, args...);
+        }
+
+        Pipeline& CommandArgv(std::initializer_list<Arg> args) {
+            return Append(eReplyAny, nullptr, args);
+        }
+
+        Pipeline& Set(const TKey& key, const TValue& value, const int second = 0) {
+            if (0 == second) {
+                return Append(eReplyBool, nullptr, {"SET", key, value});
+            }
+            return Append(eReplyBool, nullptr, {"SET", key, value, "EX", second});
+        }
+
+        Pipeline& Get(const TKey& key, TValue* value) {
+            return Append(eReplyString, value, {"GET", key});
+        }
+
+        Pipeline& Del(const TKey& key, int64_t* num = nullptr) {
+            return Append(eReplyInteger, num, {"DEL", key});
+        }
+
+        Pipeline& Incr(const TKey& key, int64_t* result = nullptr) {
+            return Append(eReplyInteger, result, {"INCR", key});
+        }
+
+        Pipeline& Decr(const TKey& key, int64_t* result = nullptr) {
+            return Append(eReplyInteger, result, {"DECR", key});
+        }
+
+        Pipeline& HSet(const TKey& key, const TField& filed, const TValue& value, int64_t* retval = nullptr) {
+            return Append(eReplyInteger, retval, {"HSET", key, filed, value});
+        }
+
+        Pipeline& HGet(const TKey& key, const TField& filed, TValue* value) {
+            return Append(eReplyString, value, {"HGET", key, filed});
+        }
+
+        Pipeline& HGetAll(const TKey& key, THash* ret) {
+            return Append(eReplyHash, ret, {"HGETALL", key});
+        }
+
+        Pipeline& HDel(const TKey& key, const TField& filed, int64_t* num = nullptr) {
+            return Append(eReplyInteger, num, {"HDEL", key, filed});
+        }
+
+        Pipeline& HIncrby(const TKey& key, const TField& field, int32_t increment, int64_t* value = nullptr) {
+            return Append(eReplyInteger, value, {"HINCRBY", key, field, increment});
+        }
+
+        Pipeline& HKeys(const TKey& key, TValues* values) {
+            return Append(eReplyArray, values, {"HKEYS", key});
+        }
+
+        Pipeline& RPush(const TKey& key, const TValue& value, int64_t* length = nullptr) {
+            return Append(eReplyInteger, length, {"RPUSH", key, value});
+        }
+
+        Pipeline& SAdd(const TKey& key, const TValue& value, int64_t* retval = nullptr) {
+            return Append(eReplyInteger, retval, {"SADD", key, value});
+        }
+
+        Pipeline& SMembers(const TKey& key, TValues* values) {
+            return Append(eReplyArray, values, {"SMEMBERS", key});
+        }
+
+        Pipeline& ZAdd(const TKey& key, const TField& value, const int32_t& score, int64_t* retval = nullptr) {
+            return Append(eReplyInteger, retval, {"ZADD", key, score, value});
+        }
+
+        Pipeline& ZRem(const TKey& key, const TField& field, int64_t* num = nullptr) {
+            return Append(eReplyInteger, num, {"ZREM", key, field});
+        }
+
+        Pipeline& ZRangeWithScore(const TKey& key, int32_t start, int32_t end, TSSet* vValues) {
+            return Append(eReplySSet, vValues, {"ZRANGE", key, start, end, "WITHSCORES"});
+        }
+
+        Pipeline& ZRevrangeWithScore(const TKey& key, int start, int end, TSSet* vValues) {
+            return Append(eReplySSet, vValues, {"ZREVRANGE", key, start, end, "WITHSCORES"});
+        }
+
+        Pipeline& ZRevrange(const TKey& key, int start, int end, TValues* vValues) {
+            return Append(eReplyArray, vValues, {"ZREVRANGE", key, start, end});
+        }
+
+        Pipeline& Zscore(const TKey& key, const TField& member, TValue* score) {
+            return Append(eReplyString, score, {"ZSCORE", key, member});
+        }
+
+#ifdef XS_REDIS_PMR
+        Pipeline& HGetAll(const TKey& key, TPmrHash* ret) {
+            return Append(eReplyPmrHash, ret, {"HGETALL", key});
+        }
+
+        Pipeline& SMembers(const TKey& key, TPmrValues* values) {
+            return Append(eReplyPmrArray, values, {"SMEMBERS", key});
+        }
+
+        // 有 pmr 重载时传 nullptr 有歧义, 单独处理: 只检查回复, 不输出
+        Pipeline& HGetAll(const TKey& key, std::nullptr_t) {
+            return Append(eReplyHash, nullptr, {"HGETALL", key});
+        }
+
+        Pipeline& SMembers(const TKey& key, std::nullptr_t) {
+            return Append(eReplyArray, nullptr, {"SMEMBERS", key});
+        }
+#endif
+
+        // 写出所有缓冲的命令并按顺序读取结果, 全部成功返回 true
+        // 单条命令的结果用 IsOK 查询; 连接中途断开时之后的命令全部失败
+        bool Exec() {
+            _vecResults.assign(_vecSlots.size(), false);
+            redisContext* pCtx = _kRedis._pCtx;
+            bool bAllOK = true;
+            for (size_t i = 0; i < _vecSlots.size(); i++) {
+                Slot& kSlot = _vecSlots[i];
+                if (!kSlot.bQueued || !pCtx) {
+                    bAllOK = false;
+                    continue;
+                }
+                // 第一次 redisGetReply 会把整个输出缓冲写出去
+                void* pReply = nullptr;
+                if (REDIS_OK != redisGetReply(pCtx, &pReply) || !pReply) {
+                    _kRedis.SetErrInfo(std::string(pCtx->errstr));
+                    pCtx = nullptr;
+                    bAllOK = false;
+                    continue;
+                }
+                bool bOK = Convert(kSlot, static_cast<redisReply*>(pReply));
+                freeReplyObject(pReply);
+                _vecResults[i] = bOK;
+                bAllOK = bAllOK && bOK;
+            }
+            _vecSlots.clear();
+            return bAllOK;
+        }
+
+        // 上一次 Exec 中第 nIndex 条命令(从 0 开始)是否成功
+        bool IsOK(size_t nIndex) const {
+            return nIndex < _vecResults.size() && _vecResults[nIndex];
+        }
+
+        // 已提交尚未 Exec 的命令数
+        size_t Size() const {
+            return _vecSlots.size();
+        }
+
+      private:
+        enum EReplyType {
+            eReplyAny,
+            eReplyBool,
+            eReplyInteger,
+            eReplyString,
+            eReplyHash,
+            eReplyArray,
+            eReplySSet,
+            eReplyPmrHash,
+            eReplyPmrArray,
+        };
+
+        struct Slot {
+            EReplyType eType;
+            void* pOut;
+            bool bQueued;
+        };
+
+        template <typename... Args>
+        Pipeline& Append(EReplyType eType, void* pOut, const char* szFmt, Args... args) {
+            bool bQueued = false;
+            if (_kRedis._pCtx) {
+                bQueued = (REDIS_OK == redisAppendCommand(_kRedis._pCtx, szFmt, args...));
+                if (!bQueued) {
+                    _kRedis.SetErrInfo(std::string(_kRedis._pCtx->errstr));
+                }
+            }
+            _vecSlots.push_back(Slot{eType, pOut, bQueued});
+            return *this;
+        }
+
+        // redisAppendCommandArgv 立即把命令编码进输出缓冲, 之后即可复用连接的 argv 数组
+        Pipeline& Append(EReplyType eType, void* pOut, std::initializer_list<Arg> args) {
+            bool bQueued = false;
+            if (_kRedis._pCtx) {
+                _kRedis.ArgvBegin();
+                for (const Arg& kArg : args) {
+                    _kRedis.ArgvPush(kArg.View());
+                }
+                bQueued = (REDIS_OK == redisAppendCommandArgv(_kRedis._pCtx, (int)_kRedis._vecArgv.size(),
+                                                              _kRedis._vecArgv.data(), _kRedis._vecArgvLen.data()));
+                if (!bQueued) {
+                    _kRedis.SetErrInfo(std::string(_kRedis._pCtx->errstr));
+                }
+            }
+            _vecSlots.push_back(Slot{eType, pOut, bQueued});
+            return *this;
+        }
+
+        bool Convert(const Slot& kSlot, const redisReply* pReply) {
+            switch (kSlot.eType) {
+            case eReplyAny:
+                if (REDIS_REPLY_ERROR == pReply->type) {
+                    _kRedis.SetErrInfo(pReply);
+                    return false;
+                }
+                return true;
+            case eReplyBool:
+                return _kRedis.ReplyBool(pReply);
+            case eReplyInteger: {
+                int64_t nIgnore = 0;
+                return _kRedis.ReplyInteger(pReply, kSlot.pOut ? *static_cast<int64_t*>(kSlot.pOut) : nIgnore);
+            }
+            default:
+                break;
+            }
+            // 没有输出参数时只检查回复类型
+            if (!kSlot.pOut) {
+                bool bOK = _kRedis.CheckReply(pReply) && (eReplyString == kSlot.eType || REDIS_REPLY_ARRAY == pReply->type);
+                if (!bOK) {
+                    _kRedis.SetErrInfo(pReply);
+                }
+                return bOK;
+            }
+            switch (kSlot.eType) {
+            case eReplyString:
+                return _kRedis.ReplyString(pReply, *static_cast<TValue*>(kSlot.pOut));
+            case eReplyHash:
+                return _kRedis.ReplyHash(pReply, *static_cast<THash*>(kSlot.pOut));
+            case eReplyArray:
+                return _kRedis.ReplyArray(pReply, *static_cast<TValues*>(kSlot.pOut));
+            case eReplySSet:
+                return _kRedis.ReplySSet(pReply, *static_cast<TSSet*>(kSlot.pOut));
+#ifdef XS_REDIS_PMR
+            case eReplyPmrHash:
+                return _kRedis.ReplyHash(pReply, *static_cast<TPmrHash*>(kSlot.pOut));
+            case eReplyPmrArray:
+                return _kRedis.ReplyArray(pReply, *static_cast<TPmrValues*>(kSlot.pOut));
+#endif
+            default:
+                return false;
+            }
+        }
+
+        HiRedisHelper& _kRedis;
+        std::vector<Slot> _vecSlots;
+        std::vector<bool> _vecResults;
+    };
+
+    template <typename... Args>
+    bool CommandBool(const char* szFmt, Args... args) {
+        auto pReply = CommandWrap(szFmt, args...);
+        return ReplyBool(pReply.get());
     }
 
     template <typename... Args>
     bool CommandInteger(int64_t& nIntval, const char* szFmt, Args... args) {
-        bool bRet = false;
         auto pReply = CommandWrap(szFmt, args...);
-        if (CheckReply(pReply)) {
-            nIntval = pReply->integer;
-            bRet = true;
-        } else {
-            SetErrInfo(pReply);
-        }
-        return bRet;
+        return ReplyInteger(pReply.get(), nIntval);
     }
 
     template <typename... Args>
     bool CommandString(TValue& strData, const char* szFmt, Args... args) {
-        bool bRet = false;
         auto pReply = CommandWrap(szFmt, args...);
-        if (CheckReply(pReply)) {
-            strData.assign(pReply->str, pReply->len);
-            bRet = true;
-        } else {
-            SetErrInfo(pReply);
-        }
-        return bRet;
+        return ReplyString(pReply.get(), strData);
     }
 
     template <typename... Args>
@@ -420,92 +884,258 @@ class HiRedisHelper {
         return pRet;
     }
 
-    // 	bool CommandArgv(const TValues& vDataIn, int64_t &nRetval)
-    // 	{
-    // 		bool bRet = false;
-    // 		std::vector<const char*> argv(vDataIn.size());
-    // 		std::vector<size_t> argvlen(vDataIn.size());
-    // 		unsigned int j = 0;
-    //
-    // 		for(TValues::const_iterator iter = vDataIn.begin(); iter != vDataIn.end(); ++iter, ++j) {
-    // 			argv[j] = iter->c_str(), argvlen[j] = iter->size();
-    // 		}
-    //
-    // 		redisReply *reply = static_cast<redisReply *>(redisCommandArgv(_pCtx, vDataIn.size(), &(argv[0]), &(argvlen[0])));
-    //
-    // 		if(CheckReply(reply)) {
-    // 			nRetval = reply->integer;
-    // 			bRet = true;
-    // 		}
-    // 		else {
-    // 			SetErrInfo(reply);
-    // 		}
-    // 		FreeReply(reply);
-    // 		return bRet;
-    // 	}
+    // redisCommandArgv 路径: 参数不经过格式串解析, 二进制安全
+    // argv/argvlen 数组是连接的成员, 命令之间复用不重新分配; 参数本身不复制
+    //   auto pReply = CommandArgv({"HSET", key, field, value});
+    RedisReplyUPtr CommandArgv(std::initializer_list<Arg> args) {
+        ArgvBegin();
+        for (const Arg& kArg : args) {
+            ArgvPush(kArg.View());
+        }
+        return ArgvCommand();
+    }
+
+    // 批量命令每条最多携带的 key/field/键值对个数, 0 表示不拆分
+    void SetBatchSize(size_t nSize) {
+        _nBatchSize = nSize;
+    }
+
+    // 参数个数不定时(如批量命令)逐个追加后执行
+    void ArgvBegin() {
+        _vecArgv.clear();
+        _vecArgvLen.clear();
+    }
+
+    void ArgvPush(std::string_view sv) {
+        _vecArgv.push_back(sv.data());
+        _vecArgvLen.push_back(sv.size());
+    }
+
+    RedisReplyUPtr ArgvCommand() {
+        if (!_pCtx) {
+            return nullptr;
+        }
+        void* pCommand = redisCommandArgv(_pCtx, (int)_vecArgv.size(), _vecArgv.data(), _vecArgvLen.data());
+        if (!pCommand) {
+            SetErrInfo(std::string(_pCtx->errstr));
+            return nullptr;
+        }
+        return RedisReplyUPtr(static_cast<redisReply*>(pCommand));
+    }
+
+    // 把 nTotal 个元素按 _nBatchSize 分批, fnPush(nCount) 往 argv 追加一批生成一条命令
+    // 所有批次先写入输出缓冲再逐条读取回复, fnReply(nBegin, pReply) 处理第 nBegin 个元素起的一批
+    // 某一批写入或执行失败时其它批照常执行并读完回复, 整体返回 false, 失败批次的结果保持不变
+    template <typename FPush, typename FReply>
+    bool BatchCommand(size_t nTotal, FPush&& fnPush, FReply&& fnReply) {
+        if (0 == nTotal) {
+            return true;
+        }
+        if (!_pCtx) {
+            return false;
+        }
+        size_t nStep = _nBatchSize ? _nBatchSize : nTotal;
+        bool bOK = true;
+        // 已写入缓冲的批次起点, 回复按同样顺序返回
+        std::vector<size_t> vecQueued;
+        vecQueued.reserve((nTotal + nStep - 1) / nStep);
+        for (size_t nBegin = 0; nBegin < nTotal; nBegin += nStep) {
+            ArgvBegin();
+            fnPush(std::min(nStep, nTotal - nBegin));
+            if (REDIS_OK != redisAppendCommandArgv(_pCtx, (int)_vecArgv.size(), _vecArgv.data(), _vecArgvLen.data())) {
+                SetErrInfo("batch command append failed at " + std::to_string(nBegin) + ": " + _pCtx->errstr);
+                bOK = false;
+                continue;
+            }
+            vecQueued.push_back(nBegin);
+        }
+        for (size_t nBegin : vecQueued) {
+            void* pReply = nullptr;
+            if (REDIS_OK != redisGetReply(_pCtx, &pReply) || !pReply) {
+                SetErrInfo(std::string(_pCtx->errstr));
+                return false;
+            }
+            RedisReplyUPtr pGuard(static_cast<redisReply*>(pReply));
+            bOK = fnReply(nBegin, pGuard.get()) && bOK;
+        }
+        return bOK;
+    }
+
+    static std::string_view BatchView(std::string_view sv) {
+        return sv;
+    }
+
+    static std::string_view BatchView(const TValuePtr& pValue) {
+        return pValue ? std::string_view(*pValue) : std::string_view();
+    }
 
     template <typename... Args>
     bool CommandHash(THash& ret, const char* szFmt, Args... args) {
-        bool bRet = false;
         auto pReply = CommandWrap(szFmt, args...);
-        if (CheckReply(pReply) && (pReply->type == REDIS_REPLY_ARRAY)) {
-            bRet = true;
-            for (size_t i = 0; i + 1 < pReply->elements; i += 2) {
-                redisReply* pKey = pReply->element[i];
-                redisReply* pValue = pReply->element[i + 1];
-                TKey strKey(pKey->str, pKey->len);
-                auto strValue = std::make_shared<TValue>(pValue->str, pValue->len);
-                ret.insert(std::make_pair(strKey, strValue));
-            }
-        } else {
-            SetErrInfo(pReply);
-        }
-        return bRet;
+        return ReplyHash(pReply.get(), ret);
     }
 
     template <typename... Args>
     bool CommandArray(TValues& ret, const char* szFmt, Args... args) {
-        bool bRet = false;
         auto pReply = CommandWrap(szFmt, args...);
-        if (CheckReply(pReply) && (pReply->type == REDIS_REPLY_ARRAY)) {
-            bRet = true;
-            for (size_t i = 0; i < pReply->elements; i++) {
-                redisReply* pValue = pReply->element[i];
-                auto strValue = std::make_shared<TValue>(pValue->str, pValue->len);
-                ret.push_back(strValue);
+        return ReplyArray(pReply.get(), ret);
+    }
+
+#ifdef XS_REDIS_PMR
+    template <typename... Args>
+    bool CommandHash(TPmrHash& ret, const char* szFmt, Args... args) {
+        auto pReply = CommandWrap(szFmt, args...);
+        return ReplyHash(pReply.get(), ret);
+    }
+
+    template <typename... Args>
+    bool CommandArray(TPmrValues& ret, const char* szFmt, Args... args) {
+        auto pReply = CommandWrap(szFmt, args...);
+        return ReplyArray(pReply.get(), ret);
+    }
+#endif
+
+    template <typename... Args>
+    bool CommandSSet(TSSet& ret, const char* szFmt, Args... args) {
+        auto pReply = CommandWrap(szFmt, args...);
+        return ReplySSet(pReply.get(), ret);
+    }
+
+    // 把 redisReply 转换成具体类型, 同步命令/Pipeline/RedisAsync 共用
+    // 失败时记录错误信息并返回 false
+    static bool ReplyBool(const redisReply* pReply) {
+        if (!CheckReply(pReply)) {
+            SetErrInfo(pReply);
+            return false;
+        }
+        if (REDIS_REPLY_STATUS == pReply->type) {
+            return true;
+        }
+        return pReply->integer == 1;
+    }
+
+    // PING 的回复是状态 PONG, CheckReply 只认 OK
+    static bool ReplyPong(const redisReply* pReply) {
+        if (NULL == pReply || REDIS_REPLY_STATUS != pReply->type) {
+            SetErrInfo(pReply);
+            return false;
+        }
+        return pReply->len == 4 && 0 == memcmp(pReply->str, "PONG", 4);
+    }
+
+    static bool ReplyInteger(const redisReply* pReply, int64_t& nIntval) {
+        if (!CheckReply(pReply)) {
+            SetErrInfo(pReply);
+            return false;
+        }
+        nIntval = pReply->integer;
+        return true;
+    }
+
+    static bool ReplyString(const redisReply* pReply, TValue& strData) {
+        if (!CheckReply(pReply)) {
+            SetErrInfo(pReply);
+            return false;
+        }
+        strData.assign(pReply->str, pReply->len);
+        return true;
+    }
+
+    static bool ReplyHash(const redisReply* pReply, THash& ret) {
+        if (!CheckReply(pReply) || pReply->type != REDIS_REPLY_ARRAY) {
+            SetErrInfo(pReply);
+            return false;
+        }
+        for (size_t i = 0; i + 1 < pReply->elements; i += 2) {
+            redisReply* pKey = pReply->element[i];
+            redisReply* pValue = pReply->element[i + 1];
+            TKey strKey(pKey->str, pKey->len);
+            auto strValue = std::make_shared<TValue>(pValue->str, pValue->len);
+            ret.insert(std::make_pair(strKey, strValue));
+        }
+        return true;
+    }
+
+    static bool ReplyArray(const redisReply* pReply, TValues& ret) {
+        if (!CheckReply(pReply) || pReply->type != REDIS_REPLY_ARRAY) {
+            SetErrInfo(pReply);
+            return false;
+        }
+        for (size_t i = 0; i < pReply->elements; i++) {
+            redisReply* pValue = pReply->element[i];
+            auto strValue = std::make_shared<TValue>(pValue->str, pValue->len);
+            ret.push_back(strValue);
+        }
+        return true;
+    }
+
+    // 数组回复逐个交给 fnVisit(nBegin + i, value), nil 元素跳过
+    template <typename F>
+    static bool ReplyVisit(const redisReply* pReply, size_t nBegin, F& fnVisit) {
+        if (!CheckReply(pReply) || pReply->type != REDIS_REPLY_ARRAY) {
+            SetErrInfo(pReply);
+            return false;
+        }
+        for (size_t i = 0; i < pReply->elements; i++) {
+            redisReply* pValue = pReply->element[i];
+            if (REDIS_REPLY_NIL != pValue->type) {
+                fnVisit(nBegin + i, std::string_view(pValue->str, pValue->len));
             }
-        } else {
+        }
+        return true;
+    }
+
+#ifdef XS_REDIS_PMR
+    static bool ReplyHash(const redisReply* pReply, TPmrHash& ret) {
+        if (!CheckReply(pReply) || pReply->type != REDIS_REPLY_ARRAY) {
             SetErrInfo(pReply);
+            return false;
         }
-        return bRet;
+        for (size_t i = 0; i + 1 < pReply->elements; i += 2) {
+            redisReply* pKey = pReply->element[i];
+            redisReply* pValue = pReply->element[i + 1];
+            ret.emplace(std::piecewise_construct, std::forward_as_tuple(pKey->str, pKey->len),
+                        std::forward_as_tuple(pValue->str, pValue->len));
+        }
+        return true;
+    }
+
+    static bool ReplyArray(const redisReply* pReply, TPmrValues& ret) {
+        if (!CheckReply(pReply) || pReply->type != REDIS_REPLY_ARRAY) {
+            SetErrInfo(pReply);
+            return false;
+        }
+        ret.reserve(ret.size() + pReply->elements);
+        for (size_t i = 0; i < pReply->elements; i++) {
+            redisReply* pValue = pReply->element[i];
+            ret.emplace_back(pValue->str, pValue->len);
+        }
+        return true;
     }
+#endif
 
 #ifndef WIN32
 #define _atoi64(val) strtoll(val, NULL, 10)
 #endif
 
-    template <typename... Args>
-    bool CommandSSet(TSSet& ret, const char* szFmt, Args... args) {
-        bool bRet = false;
-        auto pReply = CommandWrap(szFmt, args...);
-        if (CheckReply(pReply) && (pReply->type == REDIS_REPLY_ARRAY)) {
-            bRet = true;
-            for (size_t i = 0; i + 1 < pReply->elements; i += 2) {
-                auto pValue = pReply->element[i];
-                auto pScore = pReply->element[i + 1];
-                auto pItem = std::make_shared<TSSetValue>();
-                pItem->key.assign(pValue->str, pValue->len);
+    static bool ReplySSet(const redisReply* pReply, TSSet& ret) {
+        if (!CheckReply(pReply) || pReply->type != REDIS_REPLY_ARRAY) {
+            SetErrInfo(pReply);
+            return false;
+        }
+        for (size_t i = 0; i + 1 < pReply->elements; i += 2) {
+            auto pValue = pReply->element[i];
+            auto pScore = pReply->element[i + 1];
+            auto pItem = std::make_shared<TSSetValue>();
+            pItem->key.assign(pValue->str, pValue->len);
 #ifdef WIN32
-                pItem->score = ::_atoi64(pScore->str);
+            pItem->score = ::_atoi64(pScore->str);
 #else
-                pItem->score = ::strtoll(pScore->str, NULL, 10);
+            pItem->score = ::strtoll(pScore->str, NULL, 10);
 #endif
-                ret.push_back(pItem);
-            }
-        } else {
-            SetErrInfo(pReply);
+            ret.push_back(pItem);
         }
-        return bRet;
+        return true;
     }
 
     static void FreeReply(const redisReply* reply) {
@@ -516,7 +1146,7 @@ class HiRedisHelper {
 
 #define CONNECT_CLOSED_ERROR "redis connection be closed"
 
-    void SetErrInfo(RedisReplyPtr pReply) {
+    static void SetErrInfo(RedisReplyPtr pReply) {
         if (!pReply) {
             SetErrInfo(CONNECT_CLOSED_ERROR);
         } else {
@@ -524,16 +1154,15 @@ class HiRedisHelper {
         }
     }
 
-    void SetErrInfo(redisReply* p) {
+    static void SetErrInfo(const redisReply* p) {
         if (NULL == p) {
             SetErrInfo(CONNECT_CLOSED_ERROR);
-        } else {
-            redisReply* reply = (redisReply*)p;
-            SetErrInfo(std::string(reply->str, reply->len));
+        } else if (p->str) {
+            SetErrInfo(std::string(p->str, p->len));
         }
     }
 
-    void SetErrInfo(const std::string& strerr) {
+    static void SetErrInfo(const std::string& strerr) {
         if (!strerr.empty()) {
             _HIREDIS_LOG(strerr);
         }
@@ -549,7 +1178,7 @@ class HiRedisHelper {
     // 		SetErrString(szBuf, ::strlen(szBuf));
     // 	}
 
-    bool CheckReply(RedisReplyPtr pReply) {
+    static bool CheckReply(RedisReplyPtr pReply) {
         if (pReply) {
             return CheckReply(pReply.get());
         }
@@ -567,7 +1196,7 @@ class HiRedisHelper {
 	REDIS_REPLY_ARRAY       返回一个数组，查看elements的值（数组个数），通过
 	element[index]的方式访问数组元素，每个数组元素是一个redisReply对象的指针
 	*/
-    bool CheckReply(const redisReply* reply) {
+    static bool CheckReply(const redisReply* reply) {
         if (NULL == reply) {
             return false;
         }
@@ -606,6 +1235,9 @@ class HiRedisHelper {
     redisContext* _pCtx = NULL;
     std::string _strHost;
     unsigned int _nPort = 0;
+    std::vector<const char*> _vecArgv;
+    std::vector<size_t> _vecArgvLen;
+    size_t _nBatchSize = 1000;
     //std::function<void(int, std::string)> _funcErrCall = nullptr;
 };
 
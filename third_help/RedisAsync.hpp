@@ -0,0 +1,601 @@
+#pragma once
+
+// 基于 hiredis 异步接口(redisAsyncContext)的 Redis 客户端, 内部一个 I/O 线程跑 epoll 循环
+// 仅 Linux 可用; 使用前需先包含 hiredis/async.h, 需要 hiredis 1.0 及以上(redisAsyncConnectWithOptions)
+
+#ifdef __linux__
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "HiRedisHelper.hpp"
+#include "../Future.hpp"
+#include "../Coroutine.hpp"
+
+namespace xs {
+
+// RedisAsync kRedis;
+// kRedis.Connect("127.0.0.1", 6379);
+// auto kFuture = kRedis.Get(key);                                  // Future<Result<TValue>>
+// kRedis.HGetAll(key).Then([](RedisAsync::Result<THash> r) {...}); // 在 I/O 线程回调
+// auto r = co_await RedisAsync::Await(kRedis.Get(key));            // 在 I/O 线程恢复协程
+//
+// 命令在调用线程格式化, 成批交给 I/O 线程一次写出, 回复按提交顺序完成, 一个 I/O 线程可同时挂起数千条命令
+// 回调/Then/协程恢复都在 I/O 线程上执行, 不能阻塞; 耗时逻辑请投递到 TaskPool
+// 连接断开时挂起的命令全部以失败完成; 断开后立即重连, 失败则每秒重试一次, 期间提交的命令直接失败
+// 连接建立和命令回复都受 Connect 的 nOutTime 限制, 超时后断开连接, 挂起的命令全部失败, 随后自动重连
+class RedisAsync {
+  public:
+    using TKey = HiRedisHelper::TKey;
+    using TField = HiRedisHelper::TField;
+    using TValue = HiRedisHelper::TValue;
+    using TValues = HiRedisHelper::TValues;
+    using THash = HiRedisHelper::THash;
+    using TSSet = HiRedisHelper::TSSet;
+    using Arg = HiRedisHelper::Arg;
+
+    // 对应同步接口的 bool 返回值 + 输出参数
+    template <typename T>
+    struct Result {
+        bool bOK = false;
+        T value;
+
+        explicit operator bool() const {
+            return bOK;
+        }
+    };
+
+    RedisAsync() {}
+
+    ~RedisAsync() {
+        Stop();
+    }
+
+    RedisAsync(const RedisAsync&) = delete;
+    RedisAsync& operator=(const RedisAsync&) = delete;
+
+    // 启动 I/O 线程并连接, 等待首次连接(及 AUTH)完成
+    // 返回 false 时 I/O 线程仍在运行并会继续重连
+    // @param nOutTime 连接超时和命令超时(秒), 命令超时指已发出的命令超过该时间没有任何回复
+    bool Connect(const std::string& strHost, uint32_t nPort, const std::string& strPass = "", uint32_t nOutTime = 10) {
+        Stop();
+        _strHost = strHost;
+        _nPort = nPort;
+        _strPass = strPass;
+        _nTimeout = nOutTime;
+
+        _nEpollFd = epoll_create1(EPOLL_CLOEXEC);
+        _nEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (_nEpollFd < 0 || _nEventFd < 0) {
+            CloseFds();
+            return false;
+        }
+        epoll_event kEvent = {};
+        kEvent.events = EPOLLIN;
+        kEvent.data.u64 = kWakeTag;
+        epoll_ctl(_nEpollFd, EPOLL_CTL_ADD, _nEventFd, &kEvent);
+
+        _bRunning = true;
+        _bWakePending = false;
+        _pThread = std::make_unique<std::thread>(&RedisAsync::OnLoop, this);
+
+        // 命令排在连接(和 AUTH)之后发出, PING 成功即连接可用
+        Future<bool> kReady = Ping();
+        return kReady.WaitFor(std::chrono::seconds(nOutTime)) && kReady.Get();
+    }
+
+    // 停止 I/O 线程, 挂起的命令以失败完成
+    void Stop() {
+        if (!_pThread) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> kLock(_lockPending);
+            _bRunning = false;
+        }
+        Wake();
+        if (_pThread->joinable()) {
+            _pThread->join();
+        }
+        _pThread.reset();
+        CloseFds();
+    }
+
+    // 底层接口: 在 I/O 线程上调用 fnReply(redisReply*), 失败时参数为 nullptr, 回调返回后 reply 被释放
+    // 不支持 SUBSCRIBE 等一条命令多次回复的用法
+    template <typename F, typename... Args>
+    void Command(F&& fnReply, const char* szFmt, Args... args) {
+        Request* pReq = new RequestT<typename std::decay<F>::type>(std::forward<F>(fnReply));
+        pReq->nLen = redisFormatCommand(&pReq->pCmd, szFmt, args...);
+        if (pReq->nLen < 0) {
+            pReq->pCmd = nullptr;
+            Finish(pReq, nullptr);
+            return;
+        }
+        Post(pReq);
+    }
+
+    // 同 Command, 参数走 argv 编码, 二进制安全; argv 数组线程本地复用
+    template <typename F>
+    void CommandArgv(F&& fnReply, std::initializer_list<Arg> args) {
+        Request* pReq = new RequestT<typename std::decay<F>::type>(std::forward<F>(fnReply));
+        ArgvBuffer& kArgv = LocalArgv();
+        kArgv.Begin();
+        for (const Arg& kArg : args) {
+            kArgv.Push(kArg.View());
+        }
+        pReq->nLen = kArgv.Format(&pReq->pCmd);
+        if (pReq->nLen < 0) {
+            pReq->pCmd = nullptr;
+            Finish(pReq, nullptr);
+            return;
+        }
+        Post(pReq);
+    }
+
+    // connection
+    Future<bool> Ping() {
+        return CallBool(&HiRedisHelper::ReplyPong, {"PING"});
+    }
+
+    // string
+    Future<Result<TValue>> Get(const TKey& key) {
+        return Call<TValue>(&HiRedisHelper::ReplyString, {"GET", key});
+    }
+
+    Future<bool> Set(const TKey& key, const TValue& value, const int second = 0) {
+        if (0 == second) {
+            return CallBool(&HiRedisHelper::ReplyBool, {"SET", key, value});
+        }
+        return CallBool(&HiRedisHelper::ReplyBool, {"SET", key, value, "EX", second});
+    }
+
+    Future<Result<int64_t>> Incr(const TKey& key) {
+        return Call<int64_t>(&HiRedisHelper::ReplyInteger, {"INCR", key});
+    }
+
+    Future<Result<int64_t>> Decr(const TKey& key) {
+        return Call<int64_t>(&HiRedisHelper::ReplyInteger, {"DECR", key});
+    }
+
+    Future<bool> Del(const TKey& key) {
+        return CallBool(&CheckInteger, {"DEL", key});
+    }
+
+    // hash
+    Future<Result<TValue>> HGet(const TKey& key, const TField& filed) {
+        return Call<TValue>(&HiRedisHelper::ReplyString, {"HGET", key, filed});
+    }
+
+    // 与同步接口一致, 新增字段才返回 true
+    Future<bool> HSet(const TKey& key, const TField& filed, const TValue& value) {
+        return CallBool(&CheckIntegerOne, {"HSET", key, filed, value});
+    }
+
+    Future<bool> HSetnx(const TKey& key, const TField& filed, const TValue& value) {
+        return CallBool(&CheckIntegerOne, {"HSETNX", key, filed, value});
+    }
+
+    Future<Result<int64_t>> HDel(const TKey& key, const TField& filed) {
+        return Call<int64_t>(&HiRedisHelper::ReplyInteger, {"HDEL", key, filed});
+    }
+
+    Future<Result<THash>> HGetAll(const TKey& key) {
+        return Call<THash>(&HiRedisHelper::ReplyHash, {"HGETALL", key});
+    }
+
+    Future<Result<int64_t>> HIncrby(const TKey& key, const TField& field, int32_t increment) {
+        return Call<int64_t>(&HiRedisHelper::ReplyInteger, {"HINCRBY", key, field, increment});
+    }
+
+    Future<Result<TValues>> HKeys(const TKey& key) {
+        return Call<TValues>(&HiRedisHelper::ReplyArray, {"HKEYS", key});
+    }
+
+    Future<Result<int64_t>> HLen(const TKey& key) {
+        return Call<int64_t>(&HiRedisHelper::ReplyInteger, {"HLEN", key});
+    }
+
+    // list
+    Future<Result<int64_t>> RPush(const TKey& key, const TValue& value) {
+        return Call<int64_t>(&HiRedisHelper::ReplyInteger, {"RPUSH", key, value});
+    }
+
+    // set
+    Future<bool> SAdd(const TKey& key, const TValue& value) {
+        return CallBool(&CheckIntegerOne, {"SADD", key, value});
+    }
+
+    Future<Result<int64_t>> SCard(const TKey& key) {
+        return Call<int64_t>(&HiRedisHelper::ReplyInteger, {"SCARD", key});
+    }
+
+    Future<Result<TValues>> SMembers(const TKey& key) {
+        return Call<TValues>(&HiRedisHelper::ReplyArray, {"SMEMBERS", key});
+    }
+
+    Future<Result<TValue>> SPop(const TKey& key) {
+        return Call<TValue>(&HiRedisHelper::ReplyString, {"SPOP", key});
+    }
+
+    // sorted set
+    Future<bool> ZAdd(const TKey& key, const TField& value, const int32_t& score) {
+        return CallBool(&CheckInteger, {"ZADD", key, score, value});
+    }
+
+    Future<Result<int64_t>> ZCard(const TKey& key) {
+        return Call<int64_t>(&HiRedisHelper::ReplyInteger, {"ZCARD", key});
+    }
+
+    Future<Result<int64_t>> ZCount(const TKey& key, int32_t begin, int32_t end) {
+        return Call<int64_t>(&HiRedisHelper::ReplyInteger, {"ZCOUNT", key, begin, end});
+    }
+
+    Future<Result<TSSet>> ZRangeWithScore(const TKey& key, int32_t start, int32_t end) {
+        return Call<TSSet>(&HiRedisHelper::ReplySSet, {"ZRANGE", key, start, end, "WITHSCORES"});
+    }
+
+    Future<bool> ZRem(const TKey& key, const TField& field) {
+        return CallBool(&CheckInteger, {"ZREM", key, field});
+    }
+
+    Future<Result<int64_t>> ZRemRangeByRank(const TKey& key, int32_t nBegin, int32_t nEnd) {
+        return Call<int64_t>(&HiRedisHelper::ReplyInteger, {"ZREMRANGEBYRANK", key, nBegin, nEnd});
+    }
+
+    Future<Result<int64_t>> ZRemRangeByScore(const TKey& key, int32_t nBegin, int32_t nEnd) {
+        return Call<int64_t>(&HiRedisHelper::ReplyInteger, {"ZREMRANGEBYSCORE", key, nBegin, nEnd});
+    }
+
+    Future<Result<TSSet>> ZRevrangeWithScore(const TKey& key, int start, int end) {
+        return Call<TSSet>(&HiRedisHelper::ReplySSet, {"ZREVRANGE", key, start, end, "WITHSCORES"});
+    }
+
+    Future<Result<TValues>> ZRevrange(const TKey& key, int start, int end) {
+        return Call<TValues>(&HiRedisHelper::ReplyArray, {"ZREVRANGE", key, start, end});
+    }
+
+    Future<Result<TValue>> Zscore(const TKey& key, const TField& member) {
+        return Call<TValue>(&HiRedisHelper::ReplyString, {"ZSCORE", key, member});
+    }
+
+#ifdef XS_HAS_COROUTINE
+    // auto r = co_await RedisAsync::Await(kRedis.Get(key));
+    // 结果就绪后在 I/O 线程上恢复协程, 需要时再 co_await pool.Schedule() 切走
+    template <typename T>
+    static auto Await(Future<T>&& kFuture) {
+        struct Awaiter {
+            Future<T> kFuture;
+            std::optional<T> value;
+
+            bool await_ready() {
+                return kFuture.Ready();
+            }
+
+            void await_suspend(std::coroutine_handle<> h) {
+                kFuture.Then([this, h](T v) {
+                    value.emplace(std::move(v));
+                    h.resume();
+                });
+            }
+
+            T await_resume() {
+                if (value) {
+                    return std::move(*value);
+                }
+                return kFuture.Get();
+            }
+        };
+        return Awaiter{std::move(kFuture), std::nullopt};
+    }
+#endif
+
+  private:
+    static constexpr uint64_t kWakeTag = ~(uint64_t)0;
+    static constexpr int kMaxEvents = 16;
+    static constexpr int kReconnectMs = 1000;
+
+    struct ArgvBuffer {
+        std::vector<const char*> vecArgv;
+        std::vector<size_t> vecArgvLen;
+
+        void Begin() {
+            vecArgv.clear();
+            vecArgvLen.clear();
+        }
+
+        void Push(std::string_view sv) {
+            vecArgv.push_back(sv.data());
+            vecArgvLen.push_back(sv.size());
+        }
+
+        long long Format(char** ppCmd) {
+            return redisFormatCommandArgv(ppCmd, (int)vecArgv.size(), vecArgv.data(), vecArgvLen.data());
+        }
+    };
+
+    // 命令在各提交线程上编码, 每个线程一份
+    static ArgvBuffer& LocalArgv() {
+        static thread_local ArgvBuffer kBuffer;
+        return kBuffer;
+    }
+
+    struct Request {
+        virtual ~Request() {
+            if (pCmd) {
+                redisFreeCommand(pCmd);
+            }
+        }
+        virtual void OnReply(redisReply* pReply) = 0;
+
+        char* pCmd = nullptr;
+        long long nLen = 0;
+    };
+
+    template <typename F>
+    struct RequestT final : Request {
+        explicit RequestT(F&& f)
+            : fn(std::move(f)) {
+        }
+        explicit RequestT(const F& f)
+            : fn(f) {
+        }
+        void OnReply(redisReply* pReply) override {
+            fn(pReply);
+        }
+        F fn;
+    };
+
+    static bool CheckInteger(const redisReply* pReply) {
+        int64_t nIgnore = 0;
+        return HiRedisHelper::ReplyInteger(pReply, nIgnore);
+    }
+
+    static bool CheckIntegerOne(const redisReply* pReply) {
+        int64_t nRet = 0;
+        return HiRedisHelper::ReplyInteger(pReply, nRet) && nRet == 1;
+    }
+
+    template <typename T>
+    Future<Result<T>> Call(bool (*fnConvert)(const redisReply*, T&), std::initializer_list<Arg> args) {
+        Promise<Result<T>> kPromise;
+        Future<Result<T>> kFuture = kPromise.GetFuture();
+        CommandArgv([kPromise = std::move(kPromise), fnConvert](redisReply* pReply) mutable {
+            Result<T> kResult;
+            kResult.bOK = fnConvert(pReply, kResult.value);
+            kPromise.SetValue(std::move(kResult));
+        }, args);
+        return kFuture;
+    }
+
+    Future<bool> CallBool(bool (*fnCheck)(const redisReply*), std::initializer_list<Arg> args) {
+        Promise<bool> kPromise;
+        Future<bool> kFuture = kPromise.GetFuture();
+        CommandArgv([kPromise = std::move(kPromise), fnCheck](redisReply* pReply) mutable {
+            kPromise.SetValue(fnCheck(pReply));
+        }, args);
+        return kFuture;
+    }
+
+    static void Finish(Request* pReq, redisReply* pReply) {
+        pReq->OnReply(pReply);
+        delete pReq;
+    }
+
+    // 任意线程调用; 只在 I/O 线程尚未被唤醒时写 eventfd, 高并发提交时合并为一次唤醒
+    // 唤醒在锁内完成: Stop 置 _bRunning 后才会关闭 eventfd, 不会写到已关闭(或被复用)的描述符
+    void Post(Request* pReq) {
+        {
+            std::lock_guard<std::mutex> kLock(_lockPending);
+            if (_bRunning) {
+                _vecPending.push_back(pReq);
+                if (!_bWakePending.exchange(true, std::memory_order_acq_rel)) {
+                    Wake();
+                }
+                return;
+            }
+        }
+        Finish(pReq, nullptr);
+    }
+
+    void Wake() {
+        uint64_t n = 1;
+        ssize_t nRet = write(_nEventFd, &n, sizeof(n));
+        (void)nRet;
+    }
+
+    void OnLoop() {
+        Open();
+        std::vector<Request*> vecBatch;
+        epoll_event kEvents[kMaxEvents];
+        while (_bRunning.load(std::memory_order_acquire)) {
+            int nCount = epoll_wait(_nEpollFd, kEvents, kMaxEvents, WaitTimeout());
+            for (int i = 0; i < nCount; i++) {
+                if (kEvents[i].data.u64 == kWakeTag) {
+                    uint64_t n = 0;
+                    ssize_t nRet = read(_nEventFd, &n, sizeof(n));
+                    (void)nRet;
+                    _bWakePending.store(false, std::memory_order_release);
+                    continue;
+                }
+                // 回调中可能断开并释放上下文
+                if (_pCtx && (kEvents[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP))) {
+                    redisAsyncHandleRead(_pCtx);
+                }
+                if (_pCtx && (kEvents[i].events & EPOLLOUT)) {
+                    redisAsyncHandleWrite(_pCtx);
+                }
+            }
+            // hiredis 在超时回调里以 nullptr 完成挂起的命令并释放上下文
+            if (_pCtx && _bTimer && std::chrono::steady_clock::now() >= _tpTimer) {
+                _bTimer = false;
+                redisAsyncHandleTimeout(_pCtx);
+            }
+            if (!_pCtx && std::chrono::steady_clock::now() - _tpLastOpen >= std::chrono::milliseconds(kReconnectMs)) {
+                Open();
+            }
+            Flush(vecBatch);
+        }
+        // 释放上下文时 hiredis 以 nullptr 调用所有挂起命令的回调
+        if (_pCtx) {
+            redisAsyncFree(_pCtx);
+            _pCtx = nullptr;
+        }
+        Flush(vecBatch);
+    }
+
+    // 把提交队列中的命令追加到连接的输出缓冲, 由下一次可写事件一并写出
+    void Flush(std::vector<Request*>& vecBatch) {
+        {
+            std::lock_guard<std::mutex> kLock(_lockPending);
+            vecBatch.swap(_vecPending);
+        }
+        for (Request* pReq : vecBatch) {
+            if (_pCtx && REDIS_OK == redisAsyncFormattedCommand(_pCtx, OnReplyCallback, pReq, pReq->pCmd, (size_t)pReq->nLen)) {
+                // hiredis 已复制命令内容
+                redisFreeCommand(pReq->pCmd);
+                pReq->pCmd = nullptr;
+            } else {
+                Finish(pReq, nullptr);
+            }
+        }
+        vecBatch.clear();
+    }
+
+    // epoll 等待时间: 未连接时等到下次重连, 有定时器时等到超时点, 否则一直等
+    int WaitTimeout() const {
+        if (!_pCtx) {
+            return kReconnectMs;
+        }
+        if (!_bTimer) {
+            return -1;
+        }
+        auto nLeft = std::chrono::ceil<std::chrono::milliseconds>(_tpTimer - std::chrono::steady_clock::now());
+        return nLeft.count() < 0 ? 0 : (int)nLeft.count();
+    }
+
+    void Open() {
+        _tpLastOpen = std::chrono::steady_clock::now();
+        _bTimer = false;
+        timeval kTimeout{(time_t)_nTimeout, 0};
+        redisOptions kOptions = {};
+        REDIS_OPTIONS_SET_TCP(&kOptions, _strHost.c_str(), (int)_nPort);
+        kOptions.connect_timeout = &kTimeout;
+        kOptions.command_timeout = &kTimeout;
+        redisAsyncContext* pCtx = redisAsyncConnectWithOptions(&kOptions);
+        if (NULL == pCtx) {
+            return;
+        }
+        if (pCtx->err) {
+            HiRedisHelper::SetErrInfo(std::string(pCtx->errstr));
+            redisAsyncFree(pCtx);
+            return;
+        }
+        _pCtx = pCtx;
+        _nFd = pCtx->c.fd;
+        _nEvents = 0;
+        pCtx->data = this;
+        pCtx->ev.data = this;
+        pCtx->ev.addRead = [](void* p) { static_cast<RedisAsync*>(p)->UpdateEvents(EPOLLIN, 0); };
+        pCtx->ev.delRead = [](void* p) { static_cast<RedisAsync*>(p)->UpdateEvents(0, EPOLLIN); };
+        pCtx->ev.addWrite = [](void* p) { static_cast<RedisAsync*>(p)->UpdateEvents(EPOLLOUT, 0); };
+        pCtx->ev.delWrite = [](void* p) { static_cast<RedisAsync*>(p)->UpdateEvents(0, EPOLLOUT); };
+        pCtx->ev.cleanup = [](void* p) {
+            static_cast<RedisAsync*>(p)->UpdateEvents(0, EPOLLIN | EPOLLOUT);
+            static_cast<RedisAsync*>(p)->_bTimer = false;
+        };
+        // hiredis 每次注册读写事件时刷新超时, 到期由 OnLoop 调用 redisAsyncHandleTimeout
+        pCtx->ev.scheduleTimer = [](void* p, timeval tv) {
+            RedisAsync* pThis = static_cast<RedisAsync*>(p);
+            pThis->_bTimer = true;
+            pThis->_tpTimer = std::chrono::steady_clock::now() + std::chrono::seconds(tv.tv_sec) + std::chrono::microseconds(tv.tv_usec);
+        };
+        // 设置连接回调会注册可写事件, 必须在事件钩子之后
+        redisAsyncSetConnectCallback(pCtx, OnConnect);
+        redisAsyncSetDisconnectCallback(pCtx, OnDisconnect);
+        if (!_strPass.empty()) {
+            const char* argv[2] = {"AUTH", _strPass.data()};
+            size_t argvlen[2] = {4, _strPass.size()};
+            redisAsyncCommandArgv(pCtx, NULL, NULL, 2, argv, argvlen);
+        }
+    }
+
+    void UpdateEvents(uint32_t nAdd, uint32_t nDel) {
+        uint32_t nEvents = (_nEvents | nAdd) & ~nDel;
+        if (nEvents == _nEvents) {
+            return;
+        }
+        epoll_event kEvent = {};
+        kEvent.events = nEvents;
+        kEvent.data.u64 = 0;
+        int nOp = (0 == _nEvents) ? EPOLL_CTL_ADD : (0 == nEvents ? EPOLL_CTL_DEL : EPOLL_CTL_MOD);
+        epoll_ctl(_nEpollFd, nOp, _nFd, &kEvent);
+        _nEvents = nEvents;
+    }
+
+    static void OnReplyCallback(redisAsyncContext*, void* pReply, void* pData) {
+        Finish(static_cast<Request*>(pData), static_cast<redisReply*>(pReply));
+    }
+
+    // 连接失败或断开后 hiredis 会释放上下文
+    static void OnConnect(const redisAsyncContext* pCtx, int nStatus) {
+        if (REDIS_OK != nStatus) {
+            HiRedisHelper::SetErrInfo(std::string(pCtx->errstr));
+            static_cast<RedisAsync*>(pCtx->data)->_pCtx = nullptr;
+        }
+    }
+
+    static void OnDisconnect(const redisAsyncContext* pCtx, int nStatus) {
+        if (REDIS_OK != nStatus) {
+            HiRedisHelper::SetErrInfo(std::string(pCtx->errstr));
+        }
+        static_cast<RedisAsync*>(pCtx->data)->_pCtx = nullptr;
+    }
+
+    void CloseFds() {
+        if (_nEventFd >= 0) {
+            close(_nEventFd);
+            _nEventFd = -1;
+        }
+        if (_nEpollFd >= 0) {
+            close(_nEpollFd);
+            _nEpollFd = -1;
+        }
+    }
+
+    std::string _strHost;
+    uint32_t _nPort = 0;
+    std::string _strPass;
+    uint32_t _nTimeout = 10;
+
+    // 以下仅 I/O 线程访问
+    redisAsyncContext* _pCtx = nullptr;
+    int _nFd = -1;
+    uint32_t _nEvents = 0;
+    std::chrono::steady_clock::time_point _tpLastOpen;
+    bool _bTimer = false;
+    std::chrono::steady_clock::time_point _tpTimer;
+
+    int _nEpollFd = -1;
+    int _nEventFd = -1;
+    std::unique_ptr<std::thread> _pThread;
+    std::atomic<bool> _bRunning = {false};
+    std::atomic<bool> _bWakePending = {false};
+    std::mutex _lockPending;
+    std::vector<Request*> _vecPending;
+};
+} // namespace xs
+
+#endif
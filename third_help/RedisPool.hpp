@@ -0,0 +1,211 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "HiRedisHelper.hpp"
+#include "../Signal.hpp"
+#include "../Future.hpp"
+
+namespace xs {
+
+// 固定数量的 HiRedisHelper 连接池
+// 每个连接一个 busy 标记, 空闲连接数用 Signal 计数, 取还连接都没有全局锁
+// 线程优先取自己上次用过的连接, TaskPool 的工作线程基本固定在同一个连接上
+//   RedisPool kPool("127.0.0.1", 6379, 8);
+//   { auto kRedis = kPool.Acquire(); kRedis->Get(key, value); }
+//   auto kFuture = kPool.Submit(taskPool, [](HiRedisHelper& r) { ... });
+class RedisPool {
+  public:
+    // 借出的连接, 析构时归还
+    class Lease {
+      public:
+        Lease() {}
+
+        Lease(Lease&& other) noexcept
+            : _pPool(other._pPool), _nIndex(other._nIndex) {
+            other._pPool = nullptr;
+        }
+
+        Lease& operator=(Lease&& other) noexcept {
+            if (this != &other) {
+                Release();
+                _pPool = other._pPool;
+                _nIndex = other._nIndex;
+                other._pPool = nullptr;
+            }
+            return *this;
+        }
+
+        ~Lease() {
+            Release();
+        }
+
+        HiRedisHelper* operator->() const {
+            return &_pPool->_pSlots[_nIndex].kRedis;
+        }
+
+        HiRedisHelper& operator*() const {
+            return _pPool->_pSlots[_nIndex].kRedis;
+        }
+
+        // 是否借到了连接; 借到的连接也可能因服务端不可达处于断开状态, 见 IsConnected
+        explicit operator bool() const {
+            return _pPool != nullptr;
+        }
+
+        void Release() {
+            if (_pPool) {
+                _pPool->Return(_nIndex);
+                _pPool = nullptr;
+            }
+        }
+
+      private:
+        friend class RedisPool;
+
+        Lease(RedisPool* pPool, size_t nIndex)
+            : _pPool(pPool), _nIndex(nIndex) {
+        }
+
+        RedisPool* _pPool = nullptr;
+        size_t _nIndex = 0;
+    };
+
+    // @param nSize 连接数
+    // @param nPingIdleSec 空闲超过该秒数的连接借出前先 Ping, 失败则重连; 0 表示每次都检查
+    RedisPool(const std::string& strHost, uint32_t nPort, size_t nSize, const std::string& strPass = "",
+              uint32_t nTimeout = 10, uint32_t nPingIdleSec = 30)
+        : _strHost(strHost), _nPort(nPort), _strPass(strPass), _nTimeout(nTimeout),
+          _nPingIdle(std::chrono::seconds(nPingIdleSec)), _nSize(nSize ? nSize : 1) {
+        _pSlots.reset(new Slot[_nSize]);
+        _signal.Notify((int32_t)_nSize);
+    }
+
+    RedisPool(const RedisPool&) = delete;
+    RedisPool& operator=(const RedisPool&) = delete;
+
+    // 立即建立所有连接, 返回成功的连接数; 不调用则在首次借出时连接
+    // 同时借出全部连接, 保证每个连接都检查一次
+    size_t Init() {
+        std::vector<Lease> vecLease;
+        vecLease.reserve(_nSize);
+        size_t nOK = 0;
+        for (size_t i = 0; i < _nSize; i++) {
+            vecLease.push_back(Acquire());
+            if (vecLease.back()->IsConnected()) {
+                nOK++;
+            }
+        }
+        return nOK;
+    }
+
+    // 阻塞直到有空闲连接
+    Lease Acquire() {
+        _signal.Wait();
+        return Take();
+    }
+
+    // 没有空闲连接时返回空 Lease
+    Lease TryAcquire() {
+        if (!_signal.TryWait()) {
+            return Lease();
+        }
+        return Take();
+    }
+
+    // 超时返回空 Lease
+    template <typename Rep, typename Period>
+    Lease AcquireFor(const std::chrono::duration<Rep, Period>& d) {
+        if (!_signal.WaitFor(d)) {
+            return Lease();
+        }
+        return Take();
+    }
+
+    // 在线程池上执行 fn(HiRedisHelper&), 返回其结果的 Future
+    // 连接在工作线程上借出, 投递的线程不会阻塞
+    template <typename TPool, typename F>
+    auto Submit(TPool& kPool, F&& fn) {
+        return SubmitTo(kPool, [this](F& fnCall) {
+            Lease kLease = Acquire();
+            return fnCall(*kLease);
+        }, std::forward<F>(fn));
+    }
+
+    size_t Size() const {
+        return _nSize;
+    }
+
+    // 当前空闲连接数, 仅供参考
+    size_t Idle() const {
+        int32_t n = _signal.Count();
+        return n > 0 ? (size_t)n : 0;
+    }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    struct alignas(64) Slot {
+        HiRedisHelper kRedis;
+        std::atomic<bool> bBusy = {false};
+        Clock::time_point tpLastUse;
+    };
+
+    static size_t& PreferIndex() {
+        static thread_local size_t nIndex = 0;
+        return nIndex;
+    }
+
+    // 调用前已经从 _signal 取得一个名额, 一定存在空闲连接
+    Lease Take() {
+        size_t& nPrefer = PreferIndex();
+        size_t nIndex = nPrefer % _nSize;
+        while (true) {
+            for (size_t i = 0; i < _nSize; i++) {
+                Slot& kSlot = _pSlots[nIndex];
+                if (!kSlot.bBusy.load(std::memory_order_relaxed) &&
+                    !kSlot.bBusy.exchange(true, std::memory_order_acquire)) {
+                    nPrefer = nIndex;
+                    Check(kSlot);
+                    return Lease(this, nIndex);
+                }
+                nIndex = (nIndex + 1 == _nSize) ? 0 : nIndex + 1;
+            }
+            // 归还者先清 busy 再 Notify, 名额到手时空闲连接只可能被其他持名额者抢先, 再扫一轮即可
+            CpuRelax();
+        }
+    }
+
+    void Return(size_t nIndex) {
+        Slot& kSlot = _pSlots[nIndex];
+        kSlot.tpLastUse = Clock::now();
+        kSlot.bBusy.store(false, std::memory_order_release);
+        _signal.Notify();
+    }
+
+    // 断开或空闲过久 Ping 失败的连接在借出前重连
+    void Check(Slot& kSlot) {
+        HiRedisHelper& kRedis = kSlot.kRedis;
+        if (!kRedis.IsConnected()) {
+            kRedis.Connect(_strHost, _nPort, _nTimeout, _strPass);
+            return;
+        }
+        if (Clock::now() - kSlot.tpLastUse >= _nPingIdle && !kRedis.Ping()) {
+            kRedis.Reconnect();
+        }
+    }
+
+    std::string _strHost;
+    uint32_t _nPort;
+    std::string _strPass;
+    uint32_t _nTimeout;
+    Clock::duration _nPingIdle;
+    size_t _nSize;
+    std::unique_ptr<Slot[]> _pSlots;
+    Signal _signal;
+};
+} // namespace xs